@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace marketsim::common::clock {
+
+/**
+ * @brief How a SimClock's time advances
+ */
+enum class ClockMode : uint8_t {
+    REAL_TIME,    // Model time follows the wall clock; advance_to() sleeps until it gets there
+    VIRTUAL       // Model time jumps from event to event; advance_to() returns at once
+};
+
+inline const char* to_string(ClockMode mode) {
+    return mode == ClockMode::VIRTUAL ? "virtual" : "real-time";
+}
+
+/**
+ * @brief Parse "virtual" or "realtime"/"real-time"
+ * @return false (mode untouched) for anything else
+ */
+inline bool parse_clock_mode(const std::string& name, ClockMode& mode) {
+    if (name == "virtual") {
+        mode = ClockMode::VIRTUAL;
+    } else if (name == "realtime" || name == "real-time") {
+        mode = ClockMode::REAL_TIME;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief The time a simulation runs on
+ *
+ * Model time counts from zero at construction; now_ns() places it on the
+ * epoch (at `start_ns`, the wall clock by default) for timestamps.
+ *
+ * Generators call advance_to() with the time of their next event. REAL_TIME
+ * sleeps until the wall clock reaches it: pacing follows the schedule, so the
+ * work done per step does not add up as drift. VIRTUAL moves time there at
+ * once, so a simulated hour runs as fast as its consumers keep up.
+ *
+ * Time never goes back: threads sharing a VIRTUAL clock see the furthest any
+ * of them has advanced it. Thread-safe.
+ */
+class SimClock {
+public:
+    explicit SimClock(ClockMode mode = ClockMode::REAL_TIME, int64_t start_ns = 0)
+        : mode_(mode)
+        , start_ns_(start_ns != 0 ? start_ns : wall_ns())
+        , started_(std::chrono::steady_clock::now())
+        , elapsed_ns_(0)
+    {}
+
+    SimClock(const SimClock&) = delete;
+    SimClock& operator=(const SimClock&) = delete;
+
+    /**
+     * @brief Set model time back to zero, starting now (not while other threads use the clock)
+     */
+    void restart(int64_t start_ns = 0) {
+        start_ns_ = start_ns != 0 ? start_ns : wall_ns();
+        started_ = std::chrono::steady_clock::now();
+        elapsed_ns_.store(0, std::memory_order_relaxed);
+    }
+
+    ClockMode mode() const { return mode_; }
+    bool is_virtual() const { return mode_ == ClockMode::VIRTUAL; }
+
+    /**
+     * @brief Model time since construction
+     */
+    int64_t elapsed_ns() const {
+        if (mode_ == ClockMode::VIRTUAL) {
+            return elapsed_ns_.load(std::memory_order_acquire);
+        }
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - started_).count();
+    }
+
+    double elapsed_seconds() const { return elapsed_ns() / 1e9; }
+
+    /**
+     * @brief Model time as nanoseconds/milliseconds since the epoch
+     */
+    int64_t now_ns() const { return start_ns_ + elapsed_ns(); }
+    int64_t now_ms() const { return now_ns() / 1000000; }
+
+    /**
+     * @brief Move model time to `elapsed_ns` after construction
+     */
+    void advance_to(int64_t elapsed_ns) {
+        if (mode_ == ClockMode::REAL_TIME) {
+            std::this_thread::sleep_until(started_ + std::chrono::nanoseconds(elapsed_ns));
+            return;
+        }
+        int64_t current = elapsed_ns_.load(std::memory_order_relaxed);
+        while (current < elapsed_ns &&
+               !elapsed_ns_.compare_exchange_weak(current, elapsed_ns, std::memory_order_release,
+                                                  std::memory_order_relaxed)) {
+        }
+    }
+
+    void advance_to_seconds(double elapsed_seconds) {
+        advance_to(std::llround(elapsed_seconds * 1e9));
+    }
+
+private:
+    static int64_t wall_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    const ClockMode mode_;
+    int64_t start_ns_;
+    std::chrono::steady_clock::time_point started_;
+    std::atomic<int64_t> elapsed_ns_;   // VIRTUAL only
+};
+
+} // namespace marketsim::common::clock
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "wait_strategy.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace marketsim::common::concurrency {
+
+/**
+ * @brief Bounded lock-free multi-producer/single-consumer ring
+ *
+ * Producers claim slots with a CAS on the tail (a batch claims a contiguous
+ * run in one CAS), fill them, then publish each slot through its sequence
+ * number. The single consumer reads slots in order as they are published,
+ * so items from one producer keep their relative order.
+ *
+ * Same API and wait/stop semantics as SpscRing.
+ */
+template<typename T>
+class MpscRing {
+public:
+    /**
+     * @brief Construct a ring
+     * @param capacity Minimum number of slots (rounded up to a power of two)
+     * @param strategy How to wait when full/empty
+     */
+    explicit MpscRing(size_t capacity, WaitStrategy strategy = WaitStrategy::BLOCK)
+        : tail_(0)
+        , head_(0)
+        , capacity_(round_up_pow2(capacity))
+        , mask_(capacity_ - 1)
+        , slots_(std::make_unique<Slot[]>(capacity_))
+        , not_empty_(strategy)
+        , not_full_(strategy)
+        , stopped_(false)
+    {
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // ===== Producer side (any thread) =====
+
+    /**
+     * @brief Push one item if there is room (value is left untouched if not)
+     */
+    template<typename U>
+    bool try_push(U&& value) {
+        size_t pos;
+        if (claim(1, pos) == 0) {
+            return false;
+        }
+        publish(pos, std::forward<U>(value));
+        not_empty_.notify();
+        return true;
+    }
+
+    /**
+     * @brief Push one item, waiting for room
+     * @return false if the ring was stopped first
+     */
+    template<typename U>
+    bool push(U&& value) {
+        while (!try_push(std::forward<U>(value))) {
+            not_full_.wait_for([this] { return !full() || is_stopped(); }, kWaitSlice);
+            if (is_stopped()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Move up to count items in as one contiguous run
+     * @return Number of items pushed (a prefix of items)
+     */
+    size_t try_push_batch(T* items, size_t count) {
+        size_t pos;
+        size_t n = claim(count, pos);
+        for (size_t i = 0; i < n; ++i) {
+            publish(pos + i, std::move(items[i]));
+        }
+        if (n > 0) {
+            not_empty_.notify();
+        }
+        return n;
+    }
+
+    /**
+     * @brief Move all count items in, waiting for room as needed
+     * @return Number of items pushed (less than count only if stopped)
+     */
+    size_t push_batch(T* items, size_t count) {
+        size_t pushed = try_push_batch(items, count);
+        while (pushed < count && !is_stopped()) {
+            not_full_.wait_for([this] { return !full() || is_stopped(); }, kWaitSlice);
+            pushed += try_push_batch(items + pushed, count - pushed);
+        }
+        return pushed;
+    }
+
+    // ===== Consumer side (one thread) =====
+
+    /**
+     * @brief Pop one item if available
+     */
+    bool try_pop(T& out) {
+        return try_pop_batch(&out, 1) == 1;
+    }
+
+    /**
+     * @brief Move up to max published items out
+     * @return Number of items popped
+     */
+    size_t try_pop_batch(T* out, size_t max) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t n = 0;
+        while (n < max) {
+            Slot& slot = slots_[(head + n) & mask_];
+            if (slot.sequence.load(std::memory_order_acquire) != head + n + 1) {
+                break;
+            }
+            out[n] = std::move(slot.value);
+            slot.sequence.store(head + n + capacity_, std::memory_order_release);
+            ++n;
+        }
+        if (n > 0) {
+            head_.store(head + n, std::memory_order_release);
+            not_full_.notify();
+        }
+        return n;
+    }
+
+    /**
+     * @brief Pop one item, waiting up to timeout
+     * @return false on timeout, or if stopped and drained
+     */
+    template<typename Rep, typename Period>
+    bool pop_for(T& out, const std::chrono::duration<Rep, Period>& timeout) {
+        return pop_batch_for(&out, 1, timeout) == 1;
+    }
+
+    /**
+     * @brief Pop up to max items, waiting up to timeout for the first one
+     * @return Number of items popped (0 on timeout, or if stopped and drained)
+     */
+    template<typename Rep, typename Period>
+    size_t pop_batch_for(T* out, size_t max, const std::chrono::duration<Rep, Period>& timeout) {
+        size_t n = try_pop_batch(out, max);
+        if (n > 0) {
+            return n;
+        }
+        not_empty_.wait_for([this] { return ready() || is_stopped(); }, timeout);
+        return try_pop_batch(out, max);
+    }
+
+    // ===== Either side =====
+
+    /**
+     * @brief Stop the ring and wake all waiters (queued items can still be popped)
+     */
+    void stop() {
+        stopped_.store(true, std::memory_order_release);
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    bool is_stopped() const { return stopped_.load(std::memory_order_acquire); }
+
+    // Claimed slots, including ones a producer is still filling
+    size_t size() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    bool full() const { return size() >= capacity_; }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Slot {
+        // pos + 1 once published for pos; pos + capacity once consumed
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    // Waits are sliced so stop() is noticed even if a wakeup is missed
+    static constexpr std::chrono::milliseconds kWaitSlice{100};
+
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    // Reserve up to count slots starting at pos; returns how many were claimed
+    size_t claim(size_t count, size_t& pos) {
+        pos = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            size_t head = head_.load(std::memory_order_acquire);
+            size_t used = pos - head;
+            if (used > capacity_) {
+                // Stale tail: the consumer has moved past it
+                pos = tail_.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            size_t free = capacity_ - used;
+            size_t n = count < free ? count : free;
+            if (n == 0) {
+                return 0;
+            }
+            if (tail_.compare_exchange_weak(pos, pos + n,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_relaxed)) {
+                return n;
+            }
+        }
+    }
+
+    template<typename U>
+    void publish(size_t pos, U&& value) {
+        Slot& slot = slots_[pos & mask_];
+        slot.value = std::forward<U>(value);
+        slot.sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    // Next slot in order has been published
+    bool ready() const {
+        size_t head = head_.load(std::memory_order_relaxed);
+        return slots_[head & mask_].sequence.load(std::memory_order_acquire) == head + 1;
+    }
+
+    // Producers contend here
+    alignas(kCacheLineSize) std::atomic<size_t> tail_;
+
+    // Consumer-owned
+    alignas(kCacheLineSize) std::atomic<size_t> head_;
+
+    // Shared, read-only after construction
+    alignas(kCacheLineSize) const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    RingSignal not_empty_;
+    RingSignal not_full_;
+    std::atomic<bool> stopped_;
+};
+
+} // namespace marketsim::common::concurrency
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "wait_strategy.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace marketsim::common::concurrency {
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer ring
+ *
+ * Capacity is rounded up to a power of two. Head and tail live on separate
+ * cache lines and each side caches the other's index, so a push or pop only
+ * touches shared state when the cached view says the ring is full or empty.
+ * Slots are default-constructed up front and reused by move assignment.
+ *
+ * try_* calls never wait. push()/pop_for() wait according to the strategy
+ * and return false once the ring is stopped.
+ */
+template<typename T>
+class SpscRing {
+public:
+    /**
+     * @brief Construct a ring
+     * @param capacity Minimum number of slots (rounded up to a power of two)
+     * @param strategy How to wait when full/empty
+     */
+    explicit SpscRing(size_t capacity, WaitStrategy strategy = WaitStrategy::BLOCK)
+        : head_(0)
+        , cached_tail_(0)
+        , tail_(0)
+        , cached_head_(0)
+        , capacity_(round_up_pow2(capacity))
+        , mask_(capacity_ - 1)
+        , slots_(std::make_unique<T[]>(capacity_))
+        , not_empty_(strategy)
+        , not_full_(strategy)
+        , stopped_(false)
+    {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // ===== Producer side =====
+
+    /**
+     * @brief Push one item if there is room (value is left untouched if not)
+     */
+    template<typename U>
+    bool try_push(U&& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ >= capacity_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ >= capacity_) {
+                return false;
+            }
+        }
+
+        slots_[tail & mask_] = std::forward<U>(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        not_empty_.notify();
+        return true;
+    }
+
+    /**
+     * @brief Push one item, waiting for room
+     * @return false if the ring was stopped first
+     */
+    template<typename U>
+    bool push(U&& value) {
+        while (!try_push(std::forward<U>(value))) {
+            not_full_.wait_for([this] { return !full() || is_stopped(); }, kWaitSlice);
+            if (is_stopped()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Move up to count items in with a single publish
+     * @return Number of items pushed (a prefix of items)
+     */
+    size_t try_push_batch(T* items, size_t count) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t free = capacity_ - (tail - cached_head_);
+        if (free < count) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            free = capacity_ - (tail - cached_head_);
+        }
+
+        size_t n = count < free ? count : free;
+        for (size_t i = 0; i < n; ++i) {
+            slots_[(tail + i) & mask_] = std::move(items[i]);
+        }
+        if (n > 0) {
+            tail_.store(tail + n, std::memory_order_release);
+            not_empty_.notify();
+        }
+        return n;
+    }
+
+    /**
+     * @brief Move all count items in, waiting for room as needed
+     * @return Number of items pushed (less than count only if stopped)
+     */
+    size_t push_batch(T* items, size_t count) {
+        size_t pushed = try_push_batch(items, count);
+        while (pushed < count && !is_stopped()) {
+            not_full_.wait_for([this] { return !full() || is_stopped(); }, kWaitSlice);
+            pushed += try_push_batch(items + pushed, count - pushed);
+        }
+        return pushed;
+    }
+
+    // ===== Consumer side =====
+
+    /**
+     * @brief Pop one item if available
+     */
+    bool try_pop(T& out) {
+        return try_pop_batch(&out, 1) == 1;
+    }
+
+    /**
+     * @brief Move up to max items out with a single release
+     * @return Number of items popped
+     */
+    size_t try_pop_batch(T* out, size_t max) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t available = cached_tail_ - head;
+        if (available < max) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            available = cached_tail_ - head;
+        }
+
+        size_t n = max < available ? max : available;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = std::move(slots_[(head + i) & mask_]);
+        }
+        if (n > 0) {
+            head_.store(head + n, std::memory_order_release);
+            not_full_.notify();
+        }
+        return n;
+    }
+
+    /**
+     * @brief Pop one item, waiting up to timeout
+     * @return false on timeout, or if stopped and drained
+     */
+    template<typename Rep, typename Period>
+    bool pop_for(T& out, const std::chrono::duration<Rep, Period>& timeout) {
+        return pop_batch_for(&out, 1, timeout) == 1;
+    }
+
+    /**
+     * @brief Pop up to max items, waiting up to timeout for the first one
+     * @return Number of items popped (0 on timeout, or if stopped and drained)
+     */
+    template<typename Rep, typename Period>
+    size_t pop_batch_for(T* out, size_t max, const std::chrono::duration<Rep, Period>& timeout) {
+        size_t n = try_pop_batch(out, max);
+        if (n > 0) {
+            return n;
+        }
+        not_empty_.wait_for([this] { return !empty() || is_stopped(); }, timeout);
+        return try_pop_batch(out, max);
+    }
+
+    // ===== Either side =====
+
+    /**
+     * @brief Stop the ring and wake all waiters (queued items can still be popped)
+     */
+    void stop() {
+        stopped_.store(true, std::memory_order_release);
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    bool is_stopped() const { return stopped_.load(std::memory_order_acquire); }
+
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    bool full() const { return size() >= capacity_; }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    // Waits are sliced so stop() is noticed even if a wakeup is missed
+    static constexpr std::chrono::milliseconds kWaitSlice{100};
+
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    // Consumer-owned
+    alignas(kCacheLineSize) std::atomic<size_t> head_;
+    size_t cached_tail_;
+
+    // Producer-owned
+    alignas(kCacheLineSize) std::atomic<size_t> tail_;
+    size_t cached_head_;
+
+    // Shared, read-only after construction
+    alignas(kCacheLineSize) const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    RingSignal not_empty_;
+    RingSignal not_full_;
+    std::atomic<bool> stopped_;
+};
+
+} // namespace marketsim::common::concurrency
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace marketsim::common::concurrency {
+
+// Cache line size used to keep producer and consumer state apart
+inline constexpr size_t kCacheLineSize = 64;
+
+/**
+ * @brief How a ring waits when it is empty (consumer) or full (producer)
+ */
+enum class WaitStrategy : uint8_t {
+    BUSY_SPIN,    // Lowest latency, burns a core
+    YIELD,        // Spin with std::this_thread::yield()
+    BLOCK         // Spin briefly, then sleep until notified
+};
+
+/**
+ * @brief Hint to the CPU that we are in a spin loop
+ */
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * @brief Wakeup channel for one side of a ring
+ *
+ * Waiters spin or yield according to the strategy; with BLOCK they park on a
+ * condition variable after a short spin. notify() only takes the mutex when
+ * somebody is actually parked, so the uncontended hand-off is a fence and a
+ * relaxed load rather than a lock and a futex wake.
+ */
+class RingSignal {
+public:
+    explicit RingSignal(WaitStrategy strategy) : strategy_(strategy), sleepers_(0) {}
+
+    RingSignal(const RingSignal&) = delete;
+    RingSignal& operator=(const RingSignal&) = delete;
+
+    /**
+     * @brief Wait until ready() holds or the timeout expires
+     * @param ready Predicate (must also become true when the ring is stopped)
+     * @return Value of ready() when the wait ended
+     */
+    template<typename Ready, typename Rep, typename Period>
+    bool wait_for(Ready ready, const std::chrono::duration<Rep, Period>& timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        for (uint32_t spin = 0;; ++spin) {
+            if (ready()) {
+                return true;
+            }
+            // Reading the clock every iteration would dominate a tight spin
+            if ((spin & 63) == 63 && std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+
+            switch (strategy_) {
+                case WaitStrategy::BUSY_SPIN:
+                    cpu_relax();
+                    break;
+                case WaitStrategy::YIELD:
+                    std::this_thread::yield();
+                    break;
+                case WaitStrategy::BLOCK:
+                    if (spin < kSpinsBeforeBlock) {
+                        cpu_relax();
+                        break;
+                    }
+                    return park(ready, deadline);
+            }
+        }
+    }
+
+    /**
+     * @brief Wake parked waiters (call after publishing progress)
+     */
+    void notify() {
+        // Pairs with the fence in park(): either we see the sleeper or it sees our progress
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) != 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_all();
+        }
+    }
+
+    /**
+     * @brief Unconditionally wake all waiters (used on stop)
+     */
+    void notify_all() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cv_.notify_all();
+    }
+
+private:
+    static constexpr uint32_t kSpinsBeforeBlock = 256;
+
+    template<typename Ready>
+    bool park(Ready& ready, std::chrono::steady_clock::time_point deadline) {
+        sleepers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        bool result;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            result = cv_.wait_until(lock, deadline, ready);
+        }
+
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        return result;
+    }
+
+    WaitStrategy strategy_;
+    std::atomic<uint32_t> sleepers_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+} // namespace marketsim::common::concurrency
@@ -1,6 +1,12 @@
 #pragma once
 
+#include "common/clock/sim_clock.h"
+#include "common/concurrency/wait_strategy.h"
+#include "exchange/repository/order_repository.h"
+#include "exchange/repository/orderbook_snapshot_repository.h"
 #include <string>
+#include <unordered_map>
+#include <cstddef>
 
 namespace marketsim::exchange::config {
 
@@ -10,14 +16,52 @@ namespace marketsim::exchange::config {
 struct ExchangeConfig {
     std::string order_port;            // Order receiving port (e.g., "tcp://*:5555")
     std::string status_port;           // Status query port (e.g., "tcp://*:5557")
+    std::string batch_port;            // OrderBatch receiving port (e.g., "tcp://*:5558")
+    std::string market_data_port;      // L2 book update PUB feed (e.g., "tcp://*:5556"; empty = off)
+    std::string recovery_port;         // REP endpoint serving BookSnapshots on request (e.g., "tcp://*:5559"; empty = off)
+    int market_data_depth;             // Levels per side tracked and published on the feed
+    int snapshot_interval_ms;          // How often full book snapshots go out for late joiners
+    int quote_interval_ms;             // Conflation period of the Quote (L1) feed; 0 = on every change
     int price_history_size;            // Number of historical price ticks to keep
+    double tick_size;                  // Default minimum price increment
+    std::unordered_map<std::string, double> symbol_tick_sizes;  // Per-symbol tick size overrides
+    size_t ladder_levels;              // Price levels held in the array-indexed ladder per side
+    size_t order_pool_size;            // Resting order nodes preallocated per symbol
+    size_t matching_threads;           // Matching shards (symbols are hashed across them)
+    bool pin_threads;                  // Pin each matching thread to its own core (off by default)
+    size_t queue_capacity;             // Slots in each inter-thread ring
+    common::concurrency::WaitStrategy queue_wait;  // How pipeline threads wait on their rings
+    repository::JournalOptions journal;            // Order journal (journal.directory empty = off)
+    repository::SnapshotOptions book_snapshots;    // Book snapshots for recovery (directory empty = off)
+    common::clock::ClockMode clock_mode;           // VIRTUAL: matching runs on the order timestamps (sender's clock)
     
-    // Default constructor
+    // Default constructor: the order, status and batch gateways and one matching
+    // shard; the feed, recovery, journal, snapshots and pinning are opt-in
     ExchangeConfig()
         : order_port("tcp://*:5555")
         , status_port("tcp://*:5557")
+        , batch_port("tcp://*:5558")
+        , market_data_port()
+        , recovery_port()
+        , market_data_depth(10)
+        , snapshot_interval_ms(1000)
+        , quote_interval_ms(100)
         , price_history_size(100)  // Keep last 100 price points
+        , tick_size(0.01)          // One cent
+        , ladder_levels(4096)      // +/- 2048 ticks around the touch
+        , order_pool_size(16384)   // ~1.3 MB of order nodes per symbol
+        , matching_threads(1)
+        , pin_threads(false)
+        , queue_capacity(16384)
+        , queue_wait(common::concurrency::WaitStrategy::BLOCK)
+        , clock_mode(common::clock::ClockMode::REAL_TIME)
     {}
+    
+    // Tick size for a symbol (override or default)
+    double tick_size_for(const std::string& symbol) const {
+        auto it = symbol_tick_sizes.find(symbol);
+        return it != symbol_tick_sizes.end() ? it->second : tick_size;
+    }
 };
 
 } // namespace marketsim::exchange::config
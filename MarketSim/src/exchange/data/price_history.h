@@ -1,8 +1,10 @@
 #pragma once
 
 #include <cstdint>
-#include <deque>
+#include <vector>
+#include <span>
 #include <chrono>
+#include <algorithm>
 
 namespace marketsim::exchange::data {
 
@@ -12,11 +14,14 @@ namespace marketsim::exchange::data {
 struct PriceTick {
     double price;
     int64_t timestamp_ms;  // Milliseconds since epoch
-    
-    PriceTick() : price(0.0), timestamp_ms(0) {}
-    
-    PriceTick(double p, int64_t ts) : price(p), timestamp_ms(ts) {}
-    
+    uint64_t sequence;     // Position in its history, from 1 (unique even when timestamps repeat)
+    double volume;         // Traded quantity (1 for ticks without a size, e.g. mids)
+
+    PriceTick() : price(0.0), timestamp_ms(0), sequence(0), volume(0.0) {}
+
+    PriceTick(double p, int64_t ts, uint64_t seq = 0, double vol = 1.0)
+        : price(p), timestamp_ms(ts), sequence(seq), volume(vol) {}
+
     static int64_t now_ms() {
         return std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()
@@ -25,58 +30,247 @@ struct PriceTick {
 };
 
 /**
- * @brief Tracks price history with configurable size
+ * @brief Aggregates over the ticks of one rolling window
+ */
+struct WindowStats {
+    size_t count = 0;
+    double volume = 0.0;
+    double vwap = 0.0;    // Volume-weighted average price (0 if empty)
+    double high = 0.0;
+    double low = 0.0;
+};
+
+/**
+ * @brief Tracks the last max_size price ticks in a fixed-capacity ring
+ *
+ * Every tick is written twice, at its slot and at slot + capacity, so the
+ * retained ticks are always one contiguous run: views are spans into the
+ * buffer and nothing is copied or allocated per add or query. Timestamps
+ * are kept monotonic, so time ranges are found by binary search.
+ *
+ * Rolling windows (add_window) keep VWAP, high, low and count over the
+ * ticks of the last duration_ms, updated in O(1) amortized per add.
+ * A window never reaches back further than the ring itself.
  */
 class PriceHistory {
 public:
     explicit PriceHistory(size_t max_size = 100)
-        : max_size_(max_size)
+        : capacity_(max_size > 0 ? max_size : 1)
+        , head_(0)
+        , size_(0)
+        , last_sequence_(0)
+        , buffer_(2 * capacity_)
     {}
-    
+
     // Add new price tick
-    void add(double price, int64_t timestamp_ms) {
+    void add(double price, int64_t timestamp_ms, double volume = 1.0) {
         // Ensure timestamps are monotonically increasing
-        if (!history_.empty() && timestamp_ms < history_.back().timestamp_ms) {
+        if (size_ > 0 && timestamp_ms < back().timestamp_ms) {
             // Use the last timestamp + 1ms if clock went backwards
-            timestamp_ms = history_.back().timestamp_ms + 1;
+            timestamp_ms = back().timestamp_ms + 1;
         }
-        
-        history_.emplace_back(price, timestamp_ms);
-        if (history_.size() > max_size_) {
-            history_.pop_front();
+
+        if (size_ == capacity_) {
+            // The oldest slot is about to be overwritten: leave the windows first
+            uint64_t oldest = front().sequence;
+            for (auto& window : windows_) {
+                if (window.count > 0 && window.first_sequence == oldest) {
+                    evict_front(window);
+                }
+            }
+            head_ = (head_ + 1) % capacity_;
+            --size_;
+        }
+
+        size_t slot = (head_ + size_) % capacity_;
+        buffer_[slot] = PriceTick(price, timestamp_ms, ++last_sequence_, volume);
+        buffer_[slot + capacity_] = buffer_[slot];
+        ++size_;
+
+        for (auto& window : windows_) {
+            push_back(window, buffer_[slot]);
         }
     }
-    
+
     // Get last price (most recent)
     bool get_last(PriceTick& tick) const {
-        if (history_.empty()) return false;
-        tick = history_.back();
+        if (size_ == 0) return false;
+        tick = back();
         return true;
     }
-    
-    // Get all history (oldest to newest)
-    const std::deque<PriceTick>& get_all() const {
-        return history_;
+
+    // All retained ticks (oldest to newest); valid until the next add()
+    std::span<const PriceTick> get_all() const {
+        return { buffer_.data() + head_, size_ };
+    }
+
+    // Last N ticks
+    std::span<const PriceTick> get_last_n(size_t n) const {
+        auto all = get_all();
+        return all.last(std::min(n, all.size()));
+    }
+
+    // Index into get_all() of the first tick with sequence > since_seq and
+    // timestamp_ms > since_ts (size() if none). Sequences are contiguous, so
+    // the sequence cursor is O(1); timestamps are monotonic, so binary search.
+    size_t first_after(uint64_t since_seq, int64_t since_ts = 0) const {
+        if (size_ == 0) return 0;
+
+        auto all = get_all();
+        size_t begin = 0;
+        uint64_t oldest = all.front().sequence;
+        if (since_seq >= oldest) {
+            begin = static_cast<size_t>(std::min<uint64_t>(since_seq - oldest + 1, size_));
+        }
+        if (since_ts > 0) {
+            auto it = std::upper_bound(all.begin() + begin, all.end(), since_ts,
+                [](int64_t ts, const PriceTick& tick) { return ts < tick.timestamp_ms; });
+            begin = it - all.begin();
+        }
+        return begin;
+    }
+
+    // Ticks with from_ts <= timestamp_ms < to_ts
+    std::span<const PriceTick> between(int64_t from_ts, int64_t to_ts) const {
+        auto all = get_all();
+        auto by_time = [](const PriceTick& tick, int64_t ts) { return tick.timestamp_ms < ts; };
+        auto first = std::lower_bound(all.begin(), all.end(), from_ts, by_time);
+        auto last = std::lower_bound(first, all.end(), to_ts, by_time);
+        return all.subspan(first - all.begin(), last - first);
+    }
+
+    /**
+     * @brief Track rolling aggregates over the last duration_ms of ticks
+     * @return Id to pass to window_stats()
+     */
+    size_t add_window(int64_t duration_ms) {
+        windows_.push_back(Window(duration_ms, capacity_));
+        Window& window = windows_.back();
+        for (const auto& tick : get_all()) {
+            push_back(window, tick);
+        }
+        return windows_.size() - 1;
+    }
+
+    // Aggregates of a window as of the newest tick
+    WindowStats window_stats(size_t window_id) const {
+        const Window& window = windows_[window_id];
+        WindowStats stats;
+        if (window.count == 0) return stats;
+
+        stats.count = window.count;
+        stats.volume = window.volume;
+        stats.vwap = window.volume > 0 ? window.notional / window.volume : 0.0;
+        stats.high = at_sequence(window.highs.front()).price;
+        stats.low = at_sequence(window.lows.front()).price;
+        return stats;
     }
-    
-    // Get last N ticks
-    std::deque<PriceTick> get_last_n(size_t n) const {
-        if (n >= history_.size()) {
-            return history_;
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+        for (auto& window : windows_) {
+            window.reset();
         }
-        return std::deque<PriceTick>(
-            history_.end() - n,
-            history_.end()
-        );
     }
-    
-    size_t size() const { return history_.size(); }
-    bool empty() const { return history_.empty(); }
-    void clear() { history_.clear(); }
-    
+
+    // Sequence of the newest tick ever added (kept across clear())
+    uint64_t last_sequence() const { return last_sequence_; }
+
 private:
-    size_t max_size_;
-    std::deque<PriceTick> history_;
+    // Fixed-capacity FIFO of sequences (no allocation after construction)
+    struct SequenceQueue {
+        std::vector<uint64_t> items;
+        size_t head = 0;
+        size_t size = 0;
+
+        explicit SequenceQueue(size_t capacity) : items(capacity) {}
+
+        bool empty() const { return size == 0; }
+        uint64_t front() const { return items[head]; }
+        uint64_t back() const { return items[(head + size - 1) % items.size()]; }
+        void push_back(uint64_t seq) { items[(head + size++) % items.size()] = seq; }
+        void pop_front() { head = (head + 1) % items.size(); --size; }
+        void pop_back() { --size; }
+        void clear() { head = 0; size = 0; }
+    };
+
+    struct Window {
+        int64_t duration_ms;
+        uint64_t first_sequence = 0;  // Oldest tick in the window
+        size_t count = 0;
+        double notional = 0.0;        // Sum of price * volume
+        double volume = 0.0;
+        SequenceQueue highs;          // Decreasing prices; front is the high
+        SequenceQueue lows;           // Increasing prices; front is the low
+
+        Window(int64_t duration, size_t capacity)
+            : duration_ms(duration), highs(capacity), lows(capacity) {}
+
+        void reset() {
+            count = 0;
+            notional = 0.0;
+            volume = 0.0;
+            highs.clear();
+            lows.clear();
+        }
+    };
+
+    const PriceTick& front() const { return buffer_[head_]; }
+    const PriceTick& back() const { return buffer_[head_ + size_ - 1]; }
+
+    // Tick with the given sequence (must be retained)
+    const PriceTick& at_sequence(uint64_t seq) const {
+        return buffer_[head_ + static_cast<size_t>(seq - front().sequence)];
+    }
+
+    void push_back(Window& window, const PriceTick& tick) {
+        if (window.count == 0) {
+            window.first_sequence = tick.sequence;
+        }
+        ++window.count;
+        window.notional += tick.price * tick.volume;
+        window.volume += tick.volume;
+
+        while (!window.highs.empty() && at_sequence(window.highs.back()).price <= tick.price) {
+            window.highs.pop_back();
+        }
+        window.highs.push_back(tick.sequence);
+        while (!window.lows.empty() && at_sequence(window.lows.back()).price >= tick.price) {
+            window.lows.pop_back();
+        }
+        window.lows.push_back(tick.sequence);
+
+        // Drop ticks that fell out of (newest - duration, newest]
+        int64_t cutoff = tick.timestamp_ms - window.duration_ms;
+        while (window.count > 0 && at_sequence(window.first_sequence).timestamp_ms <= cutoff) {
+            evict_front(window);
+        }
+    }
+
+    void evict_front(Window& window) {
+        const PriceTick& oldest = at_sequence(window.first_sequence);
+        if (--window.count == 0) {
+            window.reset();  // Also clears accumulated rounding error
+            return;
+        }
+        window.notional -= oldest.price * oldest.volume;
+        window.volume -= oldest.volume;
+        if (window.highs.front() == oldest.sequence) window.highs.pop_front();
+        if (window.lows.front() == oldest.sequence) window.lows.pop_front();
+        ++window.first_sequence;
+    }
+
+    size_t capacity_;
+    size_t head_;               // Slot of the oldest tick
+    size_t size_;
+    uint64_t last_sequence_;
+    std::vector<PriceTick> buffer_;  // 2 * capacity_: each tick mirrored at slot + capacity_
+    std::vector<Window> windows_;
 };
 
 } // namespace marketsim::exchange::data
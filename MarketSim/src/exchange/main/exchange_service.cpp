@@ -1,8 +1,76 @@
 #include "exchange_service.h"
+#include "exchange/threads/order_ingest_thread.h"
+#include "exchange/threads/order_response_thread.h"
+#include "exchange/threads/matching_engine_thread.h"
+#include "exchange/threads/market_data_server_thread.h"
+#include "exchange/repository/order_repository.h"
+#include "exchange/repository/orderbook_snapshot_repository.h"
+#include <chrono>
 #include <iostream>
+#include <thread>
 
 namespace marketsim::exchange::main {
 
+namespace {
+
+// Rebuild the books from the newest snapshot, then replay the journal records
+// after it, each into the shard that owns its symbol (shards not started yet)
+void recover(const config::ExchangeConfig& config, const std::vector<threads::MatchingEngineThread*>& shards) {
+    auto start = std::chrono::steady_clock::now();
+    
+    repository::LoadedSnapshot snapshot;
+    bool loaded = !config.book_snapshots.directory.empty() &&
+                  repository::load_latest_snapshot(config.book_snapshots.directory, snapshot);
+    size_t resting = 0;
+    for (const auto& image : snapshot.books) {
+        shards[threads::shard_for_symbol(image.symbol, shards.size())]->restore(image);
+        resting += image.orders.size();
+    }
+    
+    size_t replayed = 0;
+    size_t skipped = 0;
+    size_t torn = 0;
+    if (!config.journal.directory.empty()) {
+        repository::JournalReader reader(config.journal.directory, snapshot.journal_sequence);
+        repository::JournalRecord record;
+        Order order;
+        OrderBatch batch;
+        while (reader.next(record)) {
+            bool applied = false;
+            auto size = static_cast<int>(record.payload.size());
+            if (record.type == repository::JournalRecordType::ORDER &&
+                order.ParseFromArray(record.payload.data(), size)) {
+                applied = shards[threads::shard_for_symbol(order.symbol(), shards.size())]->replay(record.sequence, order);
+            } else if (record.type == repository::JournalRecordType::BATCH &&
+                       batch.ParseFromArray(record.payload.data(), size)) {
+                applied = shards[threads::shard_for_symbol(batch.symbol(), shards.size())]->replay(record.sequence, batch);
+            }
+            if (applied) {
+                ++replayed;
+            } else {
+                ++skipped;
+            }
+        }
+        torn = reader.torn_records();
+    }
+    
+    if (!loaded && replayed == 0) {
+        return;  // Fresh start
+    }
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "[EXCHANGE] Recovered";
+    if (loaded) {
+        std::cout << " " << snapshot.books.size() << " book(s), " << resting << " resting order(s) from "
+                  << snapshot.path << " (journal sequence " << snapshot.journal_sequence << ");";
+    }
+    std::cout << " replayed " << replayed << " journal record(s), skipped " << skipped
+              << (torn > 0 ? ", dropped " + std::to_string(torn) + " torn" : std::string())
+              << " in " << elapsed_ms << " ms\n";
+}
+
+}
+
 ExchangeService::ExchangeService(const config::ExchangeConfig& config)
     : config_(config)
     , running_(false)
@@ -22,41 +90,127 @@ ExchangeService::~ExchangeService() {
     stop();
 }
 
-ExchangeService::SymbolData& ExchangeService::get_or_create_symbol(const std::string& symbol) {
-    auto it = symbols_.find(symbol);
-    if (it == symbols_.end()) {
-        auto result = symbols_.emplace(
-            symbol,
-            std::make_unique<SymbolData>(symbol, config_.price_history_size)
-        );
-        return *result.first->second;
-    }
-    return *it->second;
-}
-
 void ExchangeService::run() {
     std::cout << "[EXCHANGE] Starting...\n";
     
     try {
         io_handler::IOContext io_context(1);
         
-        // Socket for receiving orders
-        io_handler::ZmqReplier order_replier(io_context, "Exchange_Orders", config_.order_port);
-        order_replier.bind();
-        std::cout << "[EXCHANGE] Order receiver: " << config_.order_port << "\n";
+        // Matching shards (each owns the engines for its symbols)
+        size_t shard_count = config_.matching_threads > 0 ? config_.matching_threads : 1;
+        threads::ResponseQueue responses(config_.queue_capacity, config_.queue_wait);
+        
+        // Write-ahead order journal (optional); continues an existing one
+        std::unique_ptr<repository::OrderRepository> journal;
+        if (!config_.journal.directory.empty()) {
+            journal = std::make_unique<repository::OrderRepository>(config_.journal);
+        }
+        
+        // Periodic book snapshots (optional); with the journal they bound recovery time
+        std::unique_ptr<repository::OrderBookSnapshotRepository> snapshots;
+        if (!config_.book_snapshots.directory.empty()) {
+            snapshots = std::make_unique<repository::OrderBookSnapshotRepository>(config_.book_snapshots, shard_count);
+        }
+        
+        // L2 feed (optional): shards queue book deltas and keep the price cache
+        // current, one thread publishes updates and conflated quotes
+        bool market_data_enabled = !config_.market_data_port.empty();
+        threads::MarketDataQueue market_data(market_data_enabled ? config_.queue_capacity : 1, config_.queue_wait);
+        models::PriceCache price_cache;
+        
+        std::vector<std::unique_ptr<threads::MatchingEngineThread>> shards;
+        std::vector<threads::MatchingEngineThread*> shard_ptrs;
+        for (size_t i = 0; i < shard_count; ++i) {
+            shards.push_back(std::make_unique<threads::MatchingEngineThread>(
+                i, config_, responses,
+                market_data_enabled ? &market_data : nullptr,
+                market_data_enabled ? &price_cache : nullptr,
+                snapshots.get()));
+            shard_ptrs.push_back(shards.back().get());
+        }
+        recover(config_, shard_ptrs);
         
-        // Socket for status queries
-        io_handler::ZmqReplier status_replier(io_context, "Exchange_Status", config_.status_port);
-        status_replier.bind();
+        // Declared after the shards so it is torn down first: it hands spent events back to their pools
+        std::unique_ptr<threads::MarketDataServerThread> market_data_server;
+        if (market_data_enabled) {
+            market_data_server = std::make_unique<threads::MarketDataServerThread>(
+                io_context, config_, market_data, &price_cache);
+        }
+        
+        // Ingest binds the client sockets and the inproc response endpoint
+        threads::OrderIngestThread ingest(io_context, config_, shard_ptrs, journal.get());
+        threads::OrderResponseThread responder(io_context, responses, journal.get());
+        
+        std::cout << "[EXCHANGE] Order receiver: " << config_.order_port << "\n";
+        std::cout << "[EXCHANGE] Batch receiver: " << config_.batch_port << "\n";
         std::cout << "[EXCHANGE] Status endpoint: " << config_.status_port << "\n";
+        if (market_data_enabled) {
+            std::cout << "[EXCHANGE] Market data feed: " << config_.market_data_port
+                      << " (depth " << config_.market_data_depth
+                      << ", snapshot every " << config_.snapshot_interval_ms << " ms, quotes "
+                      << (config_.quote_interval_ms > 0
+                          ? "every " + std::to_string(config_.quote_interval_ms) + " ms"
+                          : std::string("on change")) << ")\n";
+            if (!config_.recovery_port.empty()) {
+                std::cout << "[EXCHANGE] Snapshot recovery: " << config_.recovery_port << "\n";
+            }
+        }
+        if (journal) {
+            static const char* kDurability[] = { "none", "async", "sync" };
+            std::cout << "[EXCHANGE] Order journal: " << journal->directory()
+                      << " (durability " << kDurability[static_cast<int>(config_.journal.durability)]
+                      << ", from sequence " << journal->last_sequence() + 1 << ")\n";
+        }
+        if (snapshots) {
+            std::cout << "[EXCHANGE] Book snapshots: " << snapshots->directory()
+                      << " (every " << config_.book_snapshots.interval_ms << " ms, keeping "
+                      << config_.book_snapshots.retain << ")\n";
+        }
+        std::cout << "[EXCHANGE] Matching threads: " << shard_count
+                  << (config_.pin_threads ? " (pinned)" : "") << "\n";
         std::cout << "[EXCHANGE] Price history size: " << config_.price_history_size << "\n";
+        std::cout << "[EXCHANGE] Default tick size: " << config_.tick_size << "\n";
+        std::cout << "[EXCHANGE] Order pool per symbol: " << config_.order_pool_size << "\n";
+        if (config_.clock_mode == common::clock::ClockMode::VIRTUAL) {
+            std::cout << "[EXCHANGE] Clock: virtual (matching on order timestamps)\n";
+        }
         std::cout << "[EXCHANGE] Ready (silent mode - no logging)\n\n";
         
         running_ = true;
         
+        if (journal) {
+            journal->start();
+        }
+        responder.start();
+        if (market_data_server) {
+            market_data_server->start();
+        }
+        for (auto& shard : shards) {
+            shard->start();
+        }
+        if (snapshots) {
+            snapshots->start();
+        }
+        ingest.start();
+        
         while (running_) {
-            handle_order_request(order_replier);
-            handle_status_request(status_replier);
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        
+        // Stop upstream first so nothing is pushed into a stopped queue
+        ingest.stop();
+        if (snapshots) {
+            snapshots->stop();
+        }
+        for (auto& shard : shards) {
+            shard->stop();
+        }
+        responder.stop();
+        if (market_data_server) {
+            market_data_server->stop();
+        }
+        if (journal) {
+            journal->stop();  // Final flush
         }
         
     } catch (const std::exception& e) {
@@ -69,130 +223,4 @@ void ExchangeService::stop() {
     running_ = false;
 }
 
-void ExchangeService::handle_order_request(io_handler::ZmqReplier& order_replier) {
-    Order order;
-    if (order_replier.receive_request(order, 10)) {
-        // Get or create symbol data
-        auto& symbol_data = get_or_create_symbol(order.symbol());
-        
-        symbol_data.order_count++;
-        symbol_data.last_received_order = order;
-        
-        // Process order
-        auto match_result = symbol_data.engine->match_order(order);
-        
-        // No need to track last_trade_price separately - it's in the history now
-
-        // Send acknowledgement
-        OrderAck ack;
-        ack.set_order_id(order.order_id());
-        ack.set_status(match_result.success ? 
-            OrderStatus::ACCEPTED : 
-            OrderStatus::REJECTED);
-        ack.set_message(match_result.success ? "OK" : match_result.error_message);
-        ack.set_timestamp(order.timestamp());
-        
-        order_replier.send_response(ack);
-    }
-}
-
-void ExchangeService::handle_status_request(io_handler::ZmqReplier& status_replier) {
-    StatusRequest status_req;
-    if (status_replier.receive_request(status_req, 10)) {
-        const std::string& requested_symbol = status_req.symbol();
-        
-        // Build status response - FILTER BY REQUESTED SYMBOL
-        StatusResponse resp;
-        
-        auto it = symbols_.find(requested_symbol);
-        if (it != symbols_.end()) {
-            // Symbol exists - return its data
-            const auto& symbol_data = *it->second;
-            
-            resp.set_total_orders_received(symbol_data.order_count);
-            resp.set_total_trades(symbol_data.engine->total_trades());
-            resp.set_total_volume(symbol_data.engine->total_volume());
-            
-            // Set last trade price from history
-            data::PriceTick last_trade;
-            if (symbol_data.engine->get_last_trade_price(last_trade)) {
-                resp.set_last_trade_price(last_trade.price);
-                resp.set_last_trade_timestamp(last_trade.timestamp_ms);
-            } else {
-                resp.set_last_trade_price(0.0);
-                resp.set_last_trade_timestamp(0);
-            }
-            
-            // Set mid price from history
-            data::PriceTick last_mid;
-            if (symbol_data.engine->get_last_mid_price(last_mid)) {
-                resp.set_mid_price(last_mid.price);
-                resp.set_mid_price_timestamp(last_mid.timestamp_ms);
-            } else {
-                resp.set_mid_price(0.0);
-                resp.set_mid_price_timestamp(0);
-            }
-            
-            // Add trade price history
-            const auto& trade_history = symbol_data.engine->get_trade_price_history();
-            for (const auto& tick : trade_history.get_all()) {
-                auto* pb_tick = resp.add_trade_price_history();
-                pb_tick->set_price(tick.price);
-                pb_tick->set_timestamp_ms(tick.timestamp_ms);
-            }
-            
-            // Add mid price history
-            const auto& mid_history = symbol_data.engine->get_mid_price_history();
-            for (const auto& tick : mid_history.get_all()) {
-                auto* pb_tick = resp.add_mid_price_history();
-                pb_tick->set_price(tick.price);
-                pb_tick->set_timestamp_ms(tick.timestamp_ms);
-            }
-            
-            // Add last received order if available
-            if (symbol_data.order_count > 0) {
-                auto* last_order = resp.mutable_last_received_order();
-                last_order->CopyFrom(symbol_data.last_received_order);
-            }
-            
-            // Add orderbook snapshot for THIS SYMBOL ONLY
-            const auto& order_book = symbol_data.engine->get_order_book();
-            auto buy_levels = order_book.get_buy_side(5);
-            auto sell_levels = order_book.get_sell_side(5);
-            
-            auto* ob = resp.mutable_current_orderbook();
-            ob->set_symbol(requested_symbol);
-            ob->set_timestamp(0);
-            
-            // Add buy side
-            for (const auto& level : buy_levels) {
-                auto* bid = ob->add_bids();
-                bid->set_price(level.price);
-                bid->set_quantity(level.total_quantity());
-                bid->set_order_count(static_cast<int>(level.orders.size()));
-            }
-            
-            // Add sell side
-            for (const auto& level : sell_levels) {
-                auto* ask = ob->add_asks();
-                ask->set_price(level.price);
-                ask->set_quantity(level.total_quantity());
-                ask->set_order_count(static_cast<int>(level.orders.size()));
-            }
-        } else {
-            // Symbol doesn't exist yet - return empty response
-            resp.set_total_orders_received(0);
-            resp.set_total_trades(0);
-            resp.set_total_volume(0.0);
-            resp.set_last_trade_price(0.0);
-            
-            auto* ob = resp.mutable_current_orderbook();
-            ob->set_symbol(requested_symbol);
-        }
-        
-        status_replier.send_response(resp);
-    }
-}
-
 } // namespace marketsim::exchange::main
-
@@ -1,13 +1,8 @@
 #pragma once
 
-#include "exchange/operations/matching_engine.h"
 #include "exchange/config/exchange_config.h"
-#include "io_handler/io_context.h"
-#include "io_handler/zmq_replier.h"
-#include "exchange.pb.h"
-#include <memory>
+#include <atomic>
 #include <string>
-#include <unordered_map>
 
 namespace marketsim::exchange::main {
 
@@ -16,6 +11,15 @@ namespace marketsim::exchange::main {
  * 
  * All Exchange logic is here. Test files just instantiate and run.
  * Supports multiple ticker symbols with separate matching engines.
+ *
+ * Runs as a pipeline: an ingest thread owns the sockets and routes requests by
+ * symbol hash to `matching_threads` shards; a response thread serializes the
+ * replies and hands them back to the ingest thread to send. When
+ * `market_data_port` is set, the shards also queue book deltas and trades for
+ * a market data thread that publishes them as a sequenced L2 feed.
+ *
+ * On startup the books are rebuilt from the newest book snapshot (when
+ * `book_snapshots` is set) plus the order journal records after it.
  */
 class ExchangeService {
 public:
@@ -35,39 +39,18 @@ public:
     ~ExchangeService();
     
     /**
-     * @brief Start the Exchange service (blocking)
+     * @brief Start the Exchange service (blocking until stop())
      */
     void run();
     
     /**
-     * @brief Stop the Exchange service
+     * @brief Stop the Exchange service (safe to call from another thread)
      */
     void stop();
     
 private:
-    // Order tracking per symbol
-    struct SymbolData {
-        std::unique_ptr<operations::MatchingEngine> engine;
-        int order_count;
-        Order last_received_order;
-        
-        SymbolData(const std::string& symbol, size_t price_history_size)
-            : engine(std::make_unique<operations::MatchingEngine>(symbol, price_history_size))
-            , order_count(0)
-        {}
-    };
-    
-    SymbolData& get_or_create_symbol(const std::string& symbol);
-    
-    void handle_order_request(io_handler::ZmqReplier& order_replier);
-    
-    void handle_status_request(io_handler::ZmqReplier& status_replier);
-    
     config::ExchangeConfig config_;
-    bool running_;
-    
-    // Map of symbol -> matching engine and data
-    std::unordered_map<std::string, std::unique_ptr<SymbolData>> symbols_;
+    std::atomic<bool> running_;
 };
 
 } // namespace marketsim::exchange::main
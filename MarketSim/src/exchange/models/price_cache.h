@@ -4,9 +4,19 @@
 #include <unordered_map>
 #include <atomic>
 #include <mutex>
+#include <cstdint>
 
 namespace marketsim::exchange::models {
 
+// Consistent copy of a symbol's top of book
+struct QuoteSnapshot {
+    double bid = 0.0;
+    double bid_quantity = 0.0;
+    double ask = 0.0;
+    double ask_quantity = 0.0;
+    int64_t timestamp = 0;
+};
+
 struct alignas(64) SymbolPriceData {
     std::atomic<double> last_price{0.0};
     std::atomic<int64_t> last_trade_time{0};
@@ -14,6 +24,13 @@ struct alignas(64) SymbolPriceData {
     std::atomic<double> best_ask{0.0};
     std::atomic<double> volume_24h{0.0};
     std::atomic<uint64_t> trade_count{0};
+    std::atomic<double> best_bid_quantity{0.0};
+    std::atomic<double> best_ask_quantity{0.0};
+    std::atomic<int64_t> quote_time{0};
+    
+    // Seqlock over the quote fields: odd while a write is in progress, +2 per
+    // update. Quotes have a single writer (the symbol's matching thread).
+    std::atomic<uint64_t> quote_version{0};
     
     void update_trade(double price, double volume, int64_t timestamp) {
         last_price.store(price, std::memory_order_relaxed);
@@ -23,8 +40,40 @@ struct alignas(64) SymbolPriceData {
     }
     
     void update_bbo(double bid, double ask) {
+        update_quote(bid, best_bid_quantity.load(std::memory_order_relaxed),
+                     ask, best_ask_quantity.load(std::memory_order_relaxed),
+                     quote_time.load(std::memory_order_relaxed));
+    }
+    
+    void update_quote(double bid, double bid_qty, double ask, double ask_qty, int64_t timestamp) {
+        uint64_t version = quote_version.load(std::memory_order_relaxed);
+        quote_version.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
         best_bid.store(bid, std::memory_order_relaxed);
+        best_bid_quantity.store(bid_qty, std::memory_order_relaxed);
         best_ask.store(ask, std::memory_order_relaxed);
+        best_ask_quantity.store(ask_qty, std::memory_order_relaxed);
+        quote_time.store(timestamp, std::memory_order_relaxed);
+        quote_version.store(version + 2, std::memory_order_release);
+    }
+    
+    // Read the quote without tearing; returns the version it was read at
+    uint64_t read_quote(QuoteSnapshot& out) const {
+        while (true) {
+            uint64_t before = quote_version.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;  // Writer mid-update
+            }
+            out.bid = best_bid.load(std::memory_order_relaxed);
+            out.bid_quantity = best_bid_quantity.load(std::memory_order_relaxed);
+            out.ask = best_ask.load(std::memory_order_relaxed);
+            out.ask_quantity = best_ask_quantity.load(std::memory_order_relaxed);
+            out.timestamp = quote_time.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (quote_version.load(std::memory_order_relaxed) == before) {
+                return before;
+            }
+        }
     }
     
     double get_spread() const {
@@ -57,6 +106,16 @@ public:
     double get_spread(const std::string& symbol) const;
     double get_mid_price(const std::string& symbol) const;
     
+    // Visit every symbol under the map lock (only taken by get_or_create/get),
+    // fn(const std::string& symbol, const SymbolPriceData& data)
+    template<typename Fn>
+    void for_each(Fn&& fn) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [symbol, data] : prices_) {
+            fn(symbol, data);
+        }
+    }
+    
 private:
     mutable std::mutex mutex_;
     std::unordered_map<std::string, SymbolPriceData> prices_;
@@ -0,0 +1,55 @@
+#include "book_delta_tracker.h"
+#include <utility>
+
+namespace marketsim::exchange::operations {
+
+    BookDeltaTracker::BookDeltaTracker(int depth)
+        : depth_(depth > 0 ? depth : 1)
+    {
+        bids_.reserve(depth_);
+        asks_.reserve(depth_);
+        scratch_.reserve(depth_);
+    }
+
+    size_t BookDeltaTracker::diff(const OrderBook& book, std::vector<LevelDelta>& out) {
+        size_t before = out.size();
+
+        book.get_buy_side(depth_, scratch_);
+        diff_side(bids_, scratch_, true, out);
+        std::swap(bids_, scratch_);
+
+        book.get_sell_side(depth_, scratch_);
+        diff_side(asks_, scratch_, false, out);
+        std::swap(asks_, scratch_);
+
+        return out.size() - before;
+    }
+
+    void BookDeltaTracker::diff_side(const std::vector<LevelSnapshot>& before,
+                                     const std::vector<LevelSnapshot>& after,
+                                     bool is_buy, std::vector<LevelDelta>& out) {
+        // Prices come from the same tick grid, so equal levels compare exactly
+        auto ahead = [is_buy](double a, double b) { return is_buy ? a > b : a < b; };
+
+        size_t i = 0;
+        size_t j = 0;
+        while (i < before.size() || j < after.size()) {
+            if (j == after.size() || (i < before.size() && ahead(before[i].price, after[j].price))) {
+                out.push_back({ is_buy, LevelAction::REMOVE, before[i].price, 0.0, 0 });
+                ++i;
+            }
+            else if (i == before.size() || ahead(after[j].price, before[i].price)) {
+                out.push_back({ is_buy, LevelAction::ADD, after[j].price, after[j].quantity, after[j].order_count });
+                ++j;
+            }
+            else {
+                if (before[i].quantity != after[j].quantity || before[i].order_count != after[j].order_count) {
+                    out.push_back({ is_buy, LevelAction::CHANGE, after[j].price, after[j].quantity, after[j].order_count });
+                }
+                ++i;
+                ++j;
+            }
+        }
+    }
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "order_book.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace marketsim::exchange::operations {
+
+    /**
+     * @brief What happened to a price level between two diffs
+     */
+    enum class LevelAction : uint8_t {
+        ADD,      // Level entered the tracked depth
+        CHANGE,   // Quantity or order count changed
+        REMOVE    // Level emptied or fell out of the tracked depth
+    };
+
+    /**
+     * @brief One incremental L2 change
+     */
+    struct LevelDelta {
+        bool is_buy;
+        LevelAction action;
+        double price;
+        double quantity;       // New quantity (0 for REMOVE)
+        size_t order_count;    // New order count (0 for REMOVE)
+    };
+
+    /**
+     * @brief Turns successive views of an order book into L2 add/change/remove deltas
+     *
+     * Remembers the top `depth` levels per side as of the last diff() and reports
+     * only what differs now, so a feed can publish every book change without
+     * resending the book. Both views are sorted by priority, so a diff is a single
+     * merge over at most 2 * depth levels per side with no allocation once the
+     * buffers have grown. Levels crossing the depth boundary show up as ADD/REMOVE.
+     */
+    class BookDeltaTracker {
+    public:
+        explicit BookDeltaTracker(int depth = 10);
+
+        // Append changes since the previous call (the first call reports the whole
+        // tracked depth as ADDs); returns the number of deltas appended
+        size_t diff(const OrderBook& book, std::vector<LevelDelta>& out);
+
+        // Forget the last view, so the next diff reports the whole tracked depth again
+        void reset() { bids_.clear(); asks_.clear(); }
+
+        // Levels per side as of the last diff (best first)
+        const std::vector<LevelSnapshot>& bids() const { return bids_; }
+        const std::vector<LevelSnapshot>& asks() const { return asks_; }
+
+        int depth() const { return depth_; }
+
+    private:
+        static void diff_side(const std::vector<LevelSnapshot>& before,
+                              const std::vector<LevelSnapshot>& after,
+                              bool is_buy, std::vector<LevelDelta>& out);
+
+        int depth_;
+        std::vector<LevelSnapshot> bids_;
+        std::vector<LevelSnapshot> asks_;
+        std::vector<LevelSnapshot> scratch_;
+    };
+
+}
@@ -1,21 +1,25 @@
 #include "matching_engine.h"
 #include <chrono>
-#include <sstream>
-#include <iomanip>
+#include <charconv>
+#include <cstring>
 
 namespace marketsim::exchange::operations {
 
-MatchingEngine::MatchingEngine(const std::string& symbol, size_t price_history_size)
-    : order_book_(symbol)
+MatchingEngine::MatchingEngine(const std::string& symbol, size_t price_history_size,
+                               double tick_size, size_t ladder_levels, size_t expected_orders)
+    : order_book_(symbol, tick_size, ladder_levels, expected_orders)
     , trade_count_(0)
     , total_volume_(0)
     , trade_id_counter_(0)
+    , fixed_time_ns_(0)
     , trade_price_history_(price_history_size)
     , mid_price_history_(price_history_size)
 {
+    order_ids_.reserve(expected_orders);
 }
 
-    MatchResult MatchingEngine::match_order(const marketsim::exchange::Order& order) {
+    MatchResult MatchingEngine::match_order(const marketsim::exchange::Order& order,
+                                            std::vector<Fill>& fills, uint64_t taker_handle) {
         MatchResult result;
         result.success = false;
 
@@ -24,244 +28,340 @@ MatchingEngine::MatchingEngine(const std::string& symbol, size_t price_history_s
             return result;
         }
 
-        if (order.type() == marketsim::exchange::OrderType::MARKET) {
-            // Market order: execute immediately against best prices
-            TradeExecutionContext ctx;
+        release_filled_makers();
 
-            if (order.side() == marketsim::exchange::OrderSide::BUY) {
-                ctx = match_buy_order(order);
-            }
-            else {
-                ctx = match_sell_order(order);
-            }
+        TradeExecutionContext ctx;
+        ctx.fills = &fills;
+        ctx.taker_handle = taker_handle;
+        ctx.timestamp = now_ns();
+        execute(order, ctx);
+
+        result.fill_count = ctx.fill_count;
+        result.executed_quantity = order.quantity() - ctx.remaining_quantity;
+        result.execution_price = ctx.average_price;
+        
+        // Update mid price after order book changes
+        update_mid_price();
 
-            if (ctx.remaining_quantity > 0) {
-                // Partial fill - add remaining as limit order
-                OrderEntry limit_order(order.order_id(), order.client_id(),
-                    order.price() == 0 ? ctx.average_price : order.price(),
-                    order.quantity(), order.timestamp());
-                limit_order.filled_quantity = order.quantity() - ctx.remaining_quantity;
+        result.success = true;
+        return result;
+    }
 
-                bool is_buy = (order.side() == marketsim::exchange::OrderSide::BUY);
-                order_book_.add_order(limit_order, is_buy);
+    BatchResult MatchingEngine::match_batch(std::span<const marketsim::exchange::Order* const> orders,
+                                            std::vector<Fill>& fills, std::vector<OrderResult>& results) {
+        BatchResult batch;
+        results.resize(orders.size());
+
+        release_filled_makers();
+
+        TradeExecutionContext ctx;
+        ctx.fills = &fills;
+        ctx.timestamp = now_ns();
+
+        for (size_t i = 0; i < orders.size(); ++i) {
+            const marketsim::exchange::Order& order = *orders[i];
+            OrderResult& result = results[i];
+
+            if (order.symbol() != order_book_.get_symbol()) {
+                result = { 0, 0, false, "Symbol mismatch" };
+                continue;
             }
 
-            result.trades = ctx.trades;
+            ctx.taker_handle = i;
+            execute(order, ctx);
+
             result.executed_quantity = order.quantity() - ctx.remaining_quantity;
-            result.execution_price = ctx.average_price;
+            result.fill_count = static_cast<uint32_t>(ctx.fill_count);
+            result.success = true;
+            result.error = nullptr;
 
+            batch.accepted++;
+            batch.fill_count += ctx.fill_count;
+            batch.executed_quantity += result.executed_quantity;
+        }
+
+        if (batch.accepted > 0) {
+            update_mid_price();
+        }
+        return batch;
+    }
+
+    void MatchingEngine::execute(const marketsim::exchange::Order& order, TradeExecutionContext& ctx) {
+        ctx.fill_count = 0;
+
+        if (order.side() == marketsim::exchange::OrderSide::BUY) {
+            match_buy_order(order, ctx);
         }
         else {
-            // Limit order: match what we can, add rest to book
-            TradeExecutionContext ctx;
+            match_sell_order(order, ctx);
+        }
 
-            if (order.side() == marketsim::exchange::OrderSide::BUY) {
-                ctx = match_buy_order(order);
+        if (ctx.remaining_quantity > 0) {
+            if (order.type() == marketsim::exchange::OrderType::MARKET) {
+                // Partial fill - add remaining as limit order
+                rest_order(order, order.price() == 0 ? ctx.average_price : order.price(),
+                    order.quantity() - ctx.remaining_quantity);
             }
             else {
-                ctx = match_sell_order(order);
+                // Limit order: add remaining quantity to order book
+                rest_order(order, order.price(), order.quantity() - ctx.remaining_quantity);
             }
+        }
 
-            // Add remaining quantity to order book
-            if (ctx.remaining_quantity > 0) {
-                OrderEntry limit_order(order.order_id(), order.client_id(),
-                    order.price(), order.quantity(), order.timestamp());
-                limit_order.filled_quantity = order.quantity() - ctx.remaining_quantity;
-
-                bool is_buy = (order.side() == marketsim::exchange::OrderSide::BUY);
-                order_book_.add_order(limit_order, is_buy);
-            }
+        // Update statistics
+        trade_count_ += ctx.fill_count;
+        total_volume_ += order.quantity() - ctx.remaining_quantity;
+    }
 
-            result.trades = ctx.trades;
-            result.executed_quantity = order.quantity() - ctx.remaining_quantity;
-            result.execution_price = ctx.average_price;
+    int64_t MatchingEngine::now_ns() const {
+        if (fixed_time_ns_ != 0) {
+            return fixed_time_ns_;
         }
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
 
-        // Update statistics
-        trade_count_ += result.trades.size();
-        total_volume_ += result.executed_quantity;
-        
-        // Update mid price after order book changes
-        update_mid_price();
+    MatchResult MatchingEngine::match_order(const marketsim::exchange::Order& order) {
+        scratch_fills_.clear();
+        MatchResult result = match_order(order, scratch_fills_);
 
-        result.success = true;
+        result.trades.resize(scratch_fills_.size());
+        for (size_t i = 0; i < scratch_fills_.size(); ++i) {
+            fill_to_trade(scratch_fills_[i], order.order_id(), result.trades[i]);
+        }
         return result;
     }
 
+    void MatchingEngine::fill_to_trade(const Fill& fill, const std::string& taker_order_id,
+                                       marketsim::exchange::Trade& trade) const {
+        const std::string& maker_order_id = order_ids_.external(fill.maker_id);
+
+        trade.set_trade_id(format_trade_id(fill.trade_seq));
+        trade.set_symbol(order_book_.get_symbol());
+        trade.set_price(order_book_.to_price(fill.price_ticks));
+        trade.set_quantity(fill.quantity);
+        trade.set_timestamp(fill.timestamp);
+        trade.set_sequence(fill.trade_seq);
+        if (fill.aggressor_is_buy) {
+            trade.set_aggressor_side(marketsim::exchange::OrderSide::BUY);
+            trade.set_buyer_order_id(taker_order_id);
+            trade.set_seller_order_id(maker_order_id);
+        }
+        else {
+            trade.set_aggressor_side(marketsim::exchange::OrderSide::SELL);
+            trade.set_buyer_order_id(maker_order_id);
+            trade.set_seller_order_id(taker_order_id);
+        }
+    }
+
+    void MatchingEngine::release_filled_makers() {
+        for (uint64_t id : filled_makers_) {
+            order_ids_.release(id);
+        }
+        filled_makers_.clear();
+    }
+
     bool MatchingEngine::cancel_order(const std::string& order_id, const std::string& symbol) {
         if (symbol != order_book_.get_symbol()) {
             return false;
         }
 
-        // Try to cancel from buy side
-        if (order_book_.cancel_order(order_id, true)) {
+        release_filled_makers();
+
+        uint64_t id;
+        if (!order_ids_.find(order_id, id)) {
+            return false;
+        }
+
+        // Try buy side, then sell side
+        if (order_book_.cancel_order(id, true) || order_book_.cancel_order(id, false)) {
+            order_ids_.release(id);
             return true;
         }
+        return false;
+    }
+
+    bool MatchingEngine::amend_order(const std::string& order_id, const std::string& symbol, double new_quantity) {
+        if (symbol != order_book_.get_symbol()) {
+            return false;
+        }
+
+        release_filled_makers();
+
+        uint64_t id;
+        if (!order_ids_.find(order_id, id)) {
+            return false;
+        }
+
+        const OrderEntry* entry = order_book_.find_order(id);
+        if (!entry) {
+            return false;
+        }
+        bool removes = new_quantity <= entry->filled_quantity;
+
+        if (!order_book_.amend_order(id, new_quantity)) {
+            return false;
+        }
+        if (removes) {
+            order_ids_.release(id);
+        }
 
-        // Try to cancel from sell side
-        return order_book_.cancel_order(order_id, false);
+        update_mid_price();
+        return true;
     }
 
-    MatchingEngine::TradeExecutionContext MatchingEngine::match_buy_order(const marketsim::exchange::Order& buy_order) {
-        TradeExecutionContext ctx;
+    void MatchingEngine::rest_order(const marketsim::exchange::Order& order, double price, double filled_quantity) {
+        OrderEntry entry(order_ids_.assign(order.order_id()), clients_.intern(order.client_id()),
+            price, order.quantity(), order.timestamp());
+        entry.filled_quantity = filled_quantity;
+
+        bool is_buy = (order.side() == marketsim::exchange::OrderSide::BUY);
+        order_book_.add_order(entry, is_buy);
+    }
+
+    void MatchingEngine::restore_order(const std::string& order_id, const std::string& client_id, double price,
+                                       double quantity, double filled_quantity, int64_t timestamp, bool is_buy) {
+        OrderEntry entry(order_ids_.assign(order_id), clients_.intern(client_id), price, quantity, timestamp);
+        entry.filled_quantity = filled_quantity;
+        order_book_.add_order(entry, is_buy);
+    }
+
+    void MatchingEngine::finish_restore(size_t trade_count, double total_volume, uint64_t last_trade_sequence) {
+        trade_count_ = trade_count;
+        total_volume_ = total_volume;
+        trade_id_counter_ = last_trade_sequence;
+        update_mid_price();
+    }
+
+    void MatchingEngine::match_buy_order(const marketsim::exchange::Order& buy_order, TradeExecutionContext& ctx) {
         ctx.remaining_quantity = buy_order.quantity();
         ctx.average_price = 0;
         double total_filled_value = 0;
 
+        PriceTicks limit_ticks = order_book_.to_limit_ticks(buy_order.price(), true);
+        int64_t now_ms = ctx.timestamp / 1000000;
+
         // Match against sell side (lowest ask first) - DIRECT ACCESS, not copies
         while (ctx.remaining_quantity > 0) {
-            double best_ask_price = 0;
-            double best_ask_qty = 0;
+            PriceLevel* level = order_book_.best_ask_level();
             
-            if (!order_book_.get_best_ask(best_ask_price, best_ask_qty)) {
+            if (!level) {
                 break;  // No more sellers
             }
 
-            // Check if price is acceptable for limit order
+            // Check if price is acceptable for limit order (compared in ticks)
             if (buy_order.type() == marketsim::exchange::OrderType::LIMIT &&
-                best_ask_price > buy_order.price()) {
+                level->price_ticks > limit_ticks) {
                 break;  // Price too high
             }
 
-            // Get the actual sell-side map and modify it directly
-            auto& sell_side_map = order_book_.get_sell_side_map();
-            auto level_it = sell_side_map.find(best_ask_price);
-            
-            if (level_it == sell_side_map.end()) {
-                break;  // Should not happen
-            }
-
-            auto& orders = level_it->second.orders;
+            double best_ask_price = level->price;
             
             // Process orders at this price level (FIFO)
-            while (!orders.empty() && ctx.remaining_quantity > 0) {
-                auto& sell_order = orders.front();
+            while (!level->empty() && ctx.remaining_quantity > 0) {
+                OrderEntry& sell_order = *level->front();
                 
                 double fill_qty = std::min(ctx.remaining_quantity, sell_order.remaining_quantity());
                 
-                // Create trade
-                marketsim::exchange::Trade trade;
-                trade.set_trade_id(generate_trade_id());
-                trade.set_symbol(order_book_.get_symbol());
-                trade.set_price(best_ask_price);
-                trade.set_quantity(fill_qty);
-                trade.set_timestamp(std::chrono::system_clock::now().time_since_epoch().count());
-                trade.set_aggressor_side(marketsim::exchange::OrderSide::BUY);
-                trade.set_buyer_order_id(buy_order.order_id());
-                trade.set_seller_order_id(sell_order.order_id);
-                ctx.trades.push_back(trade);
+                ctx.fills->push_back({ ++trade_id_counter_, level->price_ticks, fill_qty, true,
+                                        sell_order.order_id, ctx.taker_handle, ctx.timestamp });
+                ++ctx.fill_count;
 
                 // Record trade price in history
-                int64_t now = data::PriceTick::now_ms();
-                trade_price_history_.add(best_ask_price, now);
+                trade_price_history_.add(best_ask_price, now_ms, fill_qty);
 
-                // Update filled quantity
-                sell_order.filled_quantity += fill_qty;
                 ctx.remaining_quantity -= fill_qty;
                 total_filled_value += fill_qty * best_ask_price;
 
-                // Remove if fully filled
-                if (sell_order.remaining_quantity() <= 0) {
-                    order_book_.remove_order_from_map(sell_order.order_id);
-                    orders.erase(orders.begin());
+                // Update filled quantity (removed from book if fully filled)
+                // Its wire id stays resolvable until the next call
+                uint64_t maker_id = sell_order.order_id;
+                if (order_book_.fill_order(*level, &sell_order, fill_qty)) {
+                    filled_makers_.push_back(maker_id);
                 }
             }
 
             // Remove empty price level
-            if (orders.empty()) {
-                sell_side_map.erase(level_it);
+            if (level->empty()) {
+                order_book_.remove_level(level->price_ticks, false);
             }
         }
 
         if (buy_order.quantity() - ctx.remaining_quantity > 0) {
             ctx.average_price = total_filled_value / (buy_order.quantity() - ctx.remaining_quantity);
         }
-
-        return ctx;
     }
 
-    MatchingEngine::TradeExecutionContext MatchingEngine::match_sell_order(const marketsim::exchange::Order& sell_order) {
-        TradeExecutionContext ctx;
+    void MatchingEngine::match_sell_order(const marketsim::exchange::Order& sell_order, TradeExecutionContext& ctx) {
         ctx.remaining_quantity = sell_order.quantity();
         ctx.average_price = 0;
         double total_filled_value = 0;
 
+        PriceTicks limit_ticks = order_book_.to_limit_ticks(sell_order.price(), false);
+        int64_t now_ms = ctx.timestamp / 1000000;
+
         // Match against buy side (highest bid first) - DIRECT ACCESS, not copies
         while (ctx.remaining_quantity > 0) {
-            double best_bid_price = 0;
-            double best_bid_qty = 0;
+            PriceLevel* level = order_book_.best_bid_level();
             
-            if (!order_book_.get_best_bid(best_bid_price, best_bid_qty)) {
+            if (!level) {
                 break;  // No more buyers
             }
 
-            // Check if price is acceptable for limit order
+            // Check if price is acceptable for limit order (compared in ticks)
             if (sell_order.type() == marketsim::exchange::OrderType::LIMIT &&
-                best_bid_price < sell_order.price()) {
+                level->price_ticks < limit_ticks) {
                 break;  // Price too low
             }
 
-            // Get the actual buy-side map and modify it directly
-            auto& buy_side_map = order_book_.get_buy_side_map();
-            auto level_it = buy_side_map.find(best_bid_price);
-            
-            if (level_it == buy_side_map.end()) {
-                break;  // Should not happen
-            }
-
-            auto& orders = level_it->second.orders;
+            double best_bid_price = level->price;
             
             // Process orders at this price level (FIFO)
-            while (!orders.empty() && ctx.remaining_quantity > 0) {
-                auto& buy_order = orders.front();
+            while (!level->empty() && ctx.remaining_quantity > 0) {
+                OrderEntry& buy_order = *level->front();
                 
                 double fill_qty = std::min(ctx.remaining_quantity, buy_order.remaining_quantity());
                 
-                // Create trade
-                marketsim::exchange::Trade trade;
-                trade.set_trade_id(generate_trade_id());
-                trade.set_symbol(order_book_.get_symbol());
-                trade.set_price(best_bid_price);
-                trade.set_quantity(fill_qty);
-                trade.set_timestamp(std::chrono::system_clock::now().time_since_epoch().count());
-                trade.set_aggressor_side(marketsim::exchange::OrderSide::SELL);
-                trade.set_buyer_order_id(buy_order.order_id);
-                trade.set_seller_order_id(sell_order.order_id());
-                ctx.trades.push_back(trade);
+                ctx.fills->push_back({ ++trade_id_counter_, level->price_ticks, fill_qty, false,
+                                        buy_order.order_id, ctx.taker_handle, ctx.timestamp });
+                ++ctx.fill_count;
 
                 // Record trade price in history
-                int64_t now = data::PriceTick::now_ms();
-                trade_price_history_.add(best_bid_price, now);
+                trade_price_history_.add(best_bid_price, now_ms, fill_qty);
 
-                // Update filled quantity
-                buy_order.filled_quantity += fill_qty;
                 ctx.remaining_quantity -= fill_qty;
                 total_filled_value += fill_qty * best_bid_price;
 
-                // Remove if fully filled
-                if (buy_order.remaining_quantity() <= 0) {
-                    order_book_.remove_order_from_map(buy_order.order_id);
-                    orders.erase(orders.begin());
+                // Update filled quantity (removed from book if fully filled)
+                // Its wire id stays resolvable until the next call
+                uint64_t maker_id = buy_order.order_id;
+                if (order_book_.fill_order(*level, &buy_order, fill_qty)) {
+                    filled_makers_.push_back(maker_id);
                 }
             }
 
             // Remove empty price level
-            if (orders.empty()) {
-                buy_side_map.erase(level_it);
+            if (level->empty()) {
+                order_book_.remove_level(level->price_ticks, true);
             }
         }
 
         if (sell_order.quantity() - ctx.remaining_quantity > 0) {
             ctx.average_price = total_filled_value / (sell_order.quantity() - ctx.remaining_quantity);
         }
-
-        return ctx;
     }
 
-    std::string MatchingEngine::generate_trade_id() {
-        std::ostringstream oss;
-        oss << "TRD_" << std::setfill('0') << std::setw(10) << (++trade_id_counter_);
-        return oss.str();
+    std::string MatchingEngine::format_trade_id(uint64_t trade_seq) {
+        // "TRD_" + zero-padded 10-digit sequence, without a stream
+        char digits[20];
+        auto end = std::to_chars(digits, digits + sizeof(digits), trade_seq).ptr;
+        size_t len = static_cast<size_t>(end - digits);
+        size_t pad = len < 10 ? 10 - len : 0;
+
+        std::string id(4 + pad + len, '0');
+        std::memcpy(id.data(), "TRD_", 4);
+        std::memcpy(id.data() + 4 + pad, digits, len);
+        return id;
     }
     
     void MatchingEngine::update_mid_price() {
@@ -274,16 +374,13 @@ MatchingEngine::MatchingEngine(const std::string& symbol, size_t price_history_s
         if (has_bid && has_ask) {
             // Both sides exist - calculate mid price
             double mid_price = (best_bid_price + best_ask_price) / 2.0;
-            int64_t now = data::PriceTick::now_ms();
-            mid_price_history_.add(mid_price, now);
+            mid_price_history_.add(mid_price, now_ns() / 1000000);
         } else if (has_bid) {
             // Only bid side - use bid as mid
-            int64_t now = data::PriceTick::now_ms();
-            mid_price_history_.add(best_bid_price, now);
+            mid_price_history_.add(best_bid_price, now_ns() / 1000000);
         } else if (has_ask) {
             // Only ask side - use ask as mid
-            int64_t now = data::PriceTick::now_ms();
-            mid_price_history_.add(best_ask_price, now);
+            mid_price_history_.add(best_ask_price, now_ns() / 1000000);
         }
         // If neither exists, don't add anything
     }
@@ -1,14 +1,34 @@
 #pragma once
 
 #include "order_book.h"
+#include "order_id_map.h"
 #include "exchange/data/price_history.h"
+#include "exchange/utils/intern_table.h"
 #include "exchange.pb.h"
 #include <vector>
 #include <string>
+#include <span>
 #include <cstdint>
 
 namespace marketsim::exchange::operations {
 
+    /**
+     * @brief Compact fill event emitted by the matching core
+     *
+     * maker_id is the resting order's internal id; it resolves to the wire id via
+     * MatchingEngine::external_order_id() until the next call that mutates the engine.
+     * taker_handle is whatever the caller passed to match_order (e.g. a batch index).
+     */
+    struct Fill {
+        uint64_t trade_seq;
+        PriceTicks price_ticks;
+        double quantity;
+        bool aggressor_is_buy;
+        uint64_t maker_id;
+        uint64_t taker_handle;
+        int64_t timestamp;     // Nanoseconds since epoch (one clock read per order)
+    };
+
     /**
      * @brief Result of matching a single order
      */
@@ -16,11 +36,33 @@ namespace marketsim::exchange::operations {
         std::string trade_id;
         double executed_quantity;
         double execution_price;
-        std::vector<marketsim::exchange::Trade> trades;
+        size_t fill_count;
+        std::vector<marketsim::exchange::Trade> trades;  // Only filled by the convenience overload
         std::string error_message;
         bool success;
 
-        MatchResult() : executed_quantity(0), execution_price(0), success(false) {}
+        MatchResult() : executed_quantity(0), execution_price(0), fill_count(0), success(false) {}
+    };
+
+    /**
+     * @brief Compact per-order outcome of MatchingEngine::match_batch
+     */
+    struct OrderResult {
+        double executed_quantity;
+        uint32_t fill_count;
+        bool success;
+        const char* error;     // Static reject reason, nullptr on success
+    };
+
+    /**
+     * @brief Totals for one match_batch call
+     */
+    struct BatchResult {
+        size_t accepted;
+        size_t fill_count;
+        double executed_quantity;
+
+        BatchResult() : accepted(0), fill_count(0), executed_quantity(0) {}
     };
 
     /**
@@ -29,20 +71,66 @@ namespace marketsim::exchange::operations {
      */
     class MatchingEngine {
     public:
-        explicit MatchingEngine(const std::string& symbol, size_t price_history_size = 100);
+        explicit MatchingEngine(const std::string& symbol, size_t price_history_size = 100,
+                                double tick_size = 0.01, size_t ladder_levels = 4096,
+                                size_t expected_orders = 1024);
 
-        // Submit order for matching
+        // Submit order for matching; fills are appended to `fills`
+        MatchResult match_order(const marketsim::exchange::Order& order, std::vector<Fill>& fills,
+                                uint64_t taker_handle = 0);
+
+        // Submit order for matching and get protobuf trades in the result (slow path)
         MatchResult match_order(const marketsim::exchange::Order& order);
 
+        // Match a run of orders in one pass: one clock read and one mid-price update for the
+        // whole batch. results[i] is for orders[i]; each fill's taker_handle is its order's index.
+        BatchResult match_batch(std::span<const marketsim::exchange::Order* const> orders,
+                                std::vector<Fill>& fills, std::vector<OrderResult>& results);
+
+        // Build the wire Trade for a fill (taker_order_id is the aggressor's wire id)
+        void fill_to_trade(const Fill& fill, const std::string& taker_order_id,
+                           marketsim::exchange::Trade& trade) const;
+
+        // Wire id of a resting (or just filled) order
+        const std::string& external_order_id(uint64_t order_id) const { return order_ids_.external(order_id); }
+
+        // "TRD_" + zero-padded trade sequence
+        static std::string format_trade_id(uint64_t trade_seq);
+
         // Cancel existing order
         bool cancel_order(const std::string& order_id, const std::string& symbol);
 
+        // Amend resting order quantity (see OrderBook::amend_order)
+        bool amend_order(const std::string& order_id, const std::string& symbol, double new_quantity);
+
+        // Replay / virtual clock: stamp fills and price history with this time (ns since epoch)
+        // instead of reading the clock; 0 goes back to the clock
+        void set_time(int64_t now_ns) { fixed_time_ns_ = now_ns; }
+
         // Get order book
         const OrderBook& get_order_book() const { return order_book_; }
 
+        // Visit every resting order in priority order (bids, then asks) with its wire and client ids
+        template<typename Visitor>
+        void for_each_resting_order(Visitor&& visit) const {
+            auto with_ids = [&](const OrderEntry& entry) {
+                visit(entry, order_ids_.external(entry.order_id), clients_.name(entry.client_id));
+            };
+            order_book_.for_each_order(true, with_ids);
+            order_book_.for_each_order(false, with_ids);
+        }
+
+        // Recovery: rest an order exactly as it was, without matching (call in priority order)
+        void restore_order(const std::string& order_id, const std::string& client_id, double price,
+                           double quantity, double filled_quantity, int64_t timestamp, bool is_buy);
+
+        // Recovery: carry statistics and the trade sequence over, once the orders are back
+        void finish_restore(size_t trade_count, double total_volume, uint64_t last_trade_sequence);
+
         // Statistics
         size_t total_trades() const { return trade_count_; }
         double total_volume() const { return total_volume_; }
+        uint64_t last_trade_sequence() const { return trade_id_counter_; }
         
         // Price tracking
         const data::PriceHistory& get_trade_price_history() const { return trade_price_history_; }
@@ -58,19 +146,31 @@ namespace marketsim::exchange::operations {
 
     private:
         struct TradeExecutionContext {
-            std::vector<marketsim::exchange::Trade> trades;
+            std::vector<Fill>* fills;
+            uint64_t taker_handle;
+            int64_t timestamp;
+            size_t fill_count;
             double remaining_quantity;
             double average_price;
         };
 
+        // Match one validated order, rest any remainder and update statistics
+        void execute(const marketsim::exchange::Order& order, TradeExecutionContext& ctx);
+
+        // Wall clock, or the time set by set_time()
+        int64_t now_ns() const;
+
         // Match buy order against sell side
-        TradeExecutionContext match_buy_order(const marketsim::exchange::Order& buy_order);
+        void match_buy_order(const marketsim::exchange::Order& buy_order, TradeExecutionContext& ctx);
 
         // Match sell order against buy side
-        TradeExecutionContext match_sell_order(const marketsim::exchange::Order& sell_order);
+        void match_sell_order(const marketsim::exchange::Order& sell_order, TradeExecutionContext& ctx);
+
+        // Release ids of makers filled by the previous call (kept so its fills still resolve)
+        void release_filled_makers();
 
-        // Generate unique trade ID
-        std::string generate_trade_id();
+        // Rest the unfilled part of an order in the book
+        void rest_order(const marketsim::exchange::Order& order, double price, double filled_quantity);
         
         // Update mid price after order book changes
         void update_mid_price();
@@ -78,7 +178,16 @@ namespace marketsim::exchange::operations {
         OrderBook order_book_;
         size_t trade_count_;
         double total_volume_;
-        int64_t trade_id_counter_;
+        uint64_t trade_id_counter_;
+        int64_t fixed_time_ns_;
+
+        // Wire strings <-> internal ids
+        OrderIdMap order_ids_;
+        utils::InternTable clients_;
+        std::vector<uint64_t> filled_makers_;
+
+        // Scratch buffer for the convenience match_order overload
+        std::vector<Fill> scratch_fills_;
         
         // Price tracking
         data::PriceHistory trade_price_history_;
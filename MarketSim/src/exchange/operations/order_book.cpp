@@ -2,157 +2,222 @@
 #include <algorithm>
 #include <iostream>
 #include <iomanip>
+#include <cmath>
 
 namespace marketsim::exchange::operations {
 
-    OrderBook::OrderBook(const std::string& symbol)
+    OrderBook::OrderBook(const std::string& symbol, double tick_size, size_t ladder_levels,
+                         size_t expected_orders)
         : symbol_(symbol)
+        , tick_size_(tick_size > 0 ? tick_size : 0.01)
+        , buy_side_(PriceLadder::Side::BID, ladder_levels)
+        , sell_side_(PriceLadder::Side::ASK, ladder_levels)
+        , order_price_map_(expected_orders)
     {
+        pool_.reserve(expected_orders);
+    }
+
+    namespace {
+        // Prices within this fraction of a tick of a grid point are on it
+        // (100.01 / 0.01 is 10000.999999999998)
+        constexpr double kTickEpsilon = 1e-6;
+    }
+
+    PriceTicks OrderBook::to_ticks(double price) const {
+        return static_cast<PriceTicks>(std::llround(price / tick_size_));
+    }
+
+    PriceTicks OrderBook::to_ticks_floor(double price) const {
+        return static_cast<PriceTicks>(std::floor(price / tick_size_ + kTickEpsilon));
+    }
+
+    PriceTicks OrderBook::to_ticks_ceil(double price) const {
+        return static_cast<PriceTicks>(std::ceil(price / tick_size_ - kTickEpsilon));
+    }
+
+    PriceTicks OrderBook::to_limit_ticks(double price, bool is_buy) const {
+        return is_buy ? to_ticks_floor(price) : to_ticks_ceil(price);
     }
 
     void OrderBook::add_order(const OrderEntry& order, bool is_buy) {
-        if (is_buy) {
-            auto it = buy_side_.find(order.price);
-            if (it == buy_side_.end()) {
-                buy_side_.emplace(order.price, PriceLevel(order.price));
-            }
-            buy_side_.at(order.price).orders.push_back(order);
+        // Normalize price onto the tick grid, never past the order's limit
+        PriceTicks ticks = to_limit_ticks(order.price, is_buy);
+        double price = to_price(ticks);
+
+        OrderEntry* node = pool_.acquire();
+        node->order_id = order.order_id;
+        node->client_id = order.client_id;
+        node->price = price;
+        node->price_ticks = ticks;
+        node->quantity = order.quantity;
+        node->filled_quantity = order.filled_quantity;
+        node->timestamp = order.timestamp;
+        node->is_buy = is_buy;
+
+        auto& side = is_buy ? buy_side_ : sell_side_;
+        side.get_or_create(ticks, price).push_back(node);
+
+        auto& totals = totals_for(is_buy);
+        ++totals.order_count;
+        totals.quantity += node->remaining_quantity();
+        totals.notional += node->remaining_quantity() * price;
+
+        order_price_map_.insert_or_assign(node->order_id, node);
+    }
+
+    bool OrderBook::cancel_order(uint64_t order_id, bool is_buy) {
+        OrderEntry** found = order_price_map_.find(order_id);
+        if (!found || (*found)->is_buy != is_buy) {
+            return false;
         }
-        else {
-            auto it = sell_side_.find(order.price);
-            if (it == sell_side_.end()) {
-                sell_side_.emplace(order.price, PriceLevel(order.price));
-            }
-            sell_side_.at(order.price).orders.push_back(order);
+
+        OrderEntry* node = *found;
+        auto& side = is_buy ? buy_side_ : sell_side_;
+
+        PriceLevel* level = side.find(node->price_ticks);
+        if (!level) {
+            return false;
         }
 
-        order_price_map_[order.order_id] = { order.price, is_buy };
+        PriceTicks ticks = node->price_ticks;
+        remove_order(*level, node);
+        if (level->empty()) {
+            side.erase(ticks);
+        }
+        return true;
     }
 
-    bool OrderBook::cancel_order(const std::string& order_id, bool is_buy) {
-        auto it = order_price_map_.find(order_id);
-        if (it == order_price_map_.end()) {
+    bool OrderBook::amend_order(uint64_t order_id, double new_quantity) {
+        OrderEntry** found = order_price_map_.find(order_id);
+        if (!found) {
             return false;
         }
 
-        double price = it->second.first;
+        OrderEntry* node = *found;
+        if (new_quantity <= node->filled_quantity) {
+            return cancel_order(order_id, node->is_buy);
+        }
 
-        if (is_buy) {
-            auto level_it = buy_side_.find(price);
-            if (level_it != buy_side_.end()) {
-                auto& orders = level_it->second.orders;
-                auto order_it = std::find_if(orders.begin(), orders.end(),
-                    [&order_id](const OrderEntry& o) { return o.order_id == order_id; });
-
-                if (order_it != orders.end()) {
-                    orders.erase(order_it);
-                    order_price_map_.erase(it);
-
-                    if (orders.empty()) {
-                        buy_side_.erase(level_it);
-                    }
-                    return true;
-                }
-            }
+        auto& side = node->is_buy ? buy_side_ : sell_side_;
+        PriceLevel* level = side.find(node->price_ticks);
+        if (!level) {
+            return false;
+        }
+
+        double delta = new_quantity - node->quantity;
+        if (delta > 0) {
+            // Size increase loses time priority
+            level->unlink(node);
+            node->quantity = new_quantity;
+            level->push_back(node);
         }
         else {
-            auto level_it = sell_side_.find(price);
-            if (level_it != sell_side_.end()) {
-                auto& orders = level_it->second.orders;
-                auto order_it = std::find_if(orders.begin(), orders.end(),
-                    [&order_id](const OrderEntry& o) { return o.order_id == order_id; });
-
-                if (order_it != orders.end()) {
-                    orders.erase(order_it);
-                    order_price_map_.erase(it);
-
-                    if (orders.empty()) {
-                        sell_side_.erase(level_it);
-                    }
-                    return true;
-                }
-            }
+            node->quantity = new_quantity;
+            level->quantity += delta;
         }
 
+        auto& totals = totals_for(node->is_buy);
+        totals.quantity += delta;
+        totals.notional += delta * node->price;
+        return true;
+    }
+
+    const OrderEntry* OrderBook::find_order(uint64_t order_id) const {
+        OrderEntry* const* found = order_price_map_.find(order_id);
+        return found ? *found : nullptr;
+    }
+
+    bool OrderBook::fill_order(PriceLevel& level, OrderEntry* order, double qty) {
+        level.fill(order, qty);
+
+        auto& totals = totals_for(order->is_buy);
+        totals.quantity -= qty;
+        totals.notional -= qty * level.price;
+
+        if (order->remaining_quantity() <= 0) {
+            remove_order(level, order);
+            return true;
+        }
         return false;
     }
 
+    void OrderBook::remove_order(PriceLevel& level, OrderEntry* order) {
+        double remaining = order->remaining_quantity();
+        level.unlink(order);
+
+        auto& totals = totals_for(order->is_buy);
+        if (--totals.order_count == 0) {
+            // Reset so floating-point residue cannot accumulate
+            totals = SideTotals{};
+        }
+        else {
+            totals.quantity -= remaining;
+            totals.notional -= remaining * level.price;
+        }
+
+        order_price_map_.erase(order->order_id);
+        pool_.release(order);
+    }
+
+    void OrderBook::remove_level(PriceTicks price_ticks, bool is_buy) {
+        if (is_buy) {
+            buy_side_.erase(price_ticks);
+        }
+        else {
+            sell_side_.erase(price_ticks);
+        }
+    }
+
     bool OrderBook::get_best_bid(double& price, double& quantity) const {
-        if (buy_side_.empty()) {
+        const PriceLevel* level = buy_side_.best();
+        if (!level) {
             return false;
         }
 
-        const auto& level = buy_side_.begin()->second;
-        price = level.price;
-        quantity = level.total_quantity();
+        price = level->price;
+        quantity = level->total_quantity();
         return true;
     }
 
     bool OrderBook::get_best_ask(double& price, double& quantity) const {
-        if (sell_side_.empty()) {
+        const PriceLevel* level = sell_side_.best();
+        if (!level) {
             return false;
         }
 
-        const auto& level = sell_side_.begin()->second;
-        price = level.price;
-        quantity = level.total_quantity();
+        price = level->price;
+        quantity = level->total_quantity();
         return true;
     }
 
-    std::vector<PriceLevel> OrderBook::get_buy_side(int depth) const {
-        std::vector<PriceLevel> result;
+    void OrderBook::collect_levels(const PriceLadder& side, int depth, std::vector<LevelSnapshot>& out) const {
+        out.clear();
         int count = 0;
 
-        for (const auto& [price, level] : buy_side_) {
+        for (const PriceLevel* level = side.best(); level; level = side.next(level->price_ticks)) {
             if (count++ >= depth) break;
-            result.push_back(level);
+            out.push_back({ level->price, level->total_quantity(), level->order_count });
         }
-
-        return result;
     }
 
-    std::vector<PriceLevel> OrderBook::get_sell_side(int depth) const {
-        std::vector<PriceLevel> result;
-        int count = 0;
-
-        for (const auto& [price, level] : sell_side_) {
-            if (count++ >= depth) break;
-            result.push_back(level);
-        }
-
+    std::vector<LevelSnapshot> OrderBook::get_buy_side(int depth) const {
+        std::vector<LevelSnapshot> result;
+        collect_levels(buy_side_, depth, result);
         return result;
     }
 
-    size_t OrderBook::total_buy_orders() const {
-        size_t total = 0;
-        for (const auto& [price, level] : buy_side_) {
-            total += level.orders.size();
-        }
-        return total;
-    }
-
-    size_t OrderBook::total_sell_orders() const {
-        size_t total = 0;
-        for (const auto& [price, level] : sell_side_) {
-            total += level.orders.size();
-        }
-        return total;
+    std::vector<LevelSnapshot> OrderBook::get_sell_side(int depth) const {
+        std::vector<LevelSnapshot> result;
+        collect_levels(sell_side_, depth, result);
+        return result;
     }
 
-    double OrderBook::total_buy_quantity() const {
-        double total = 0;
-        for (const auto& [price, level] : buy_side_) {
-            total += level.total_quantity();
-        }
-        return total;
+    void OrderBook::get_buy_side(int depth, std::vector<LevelSnapshot>& out) const {
+        collect_levels(buy_side_, depth, out);
     }
 
-    double OrderBook::total_sell_quantity() const {
-        double total = 0;
-        for (const auto& [price, level] : sell_side_) {
-            total += level.total_quantity();
-        }
-        return total;
+    void OrderBook::get_sell_side(int depth, std::vector<LevelSnapshot>& out) const {
+        collect_levels(sell_side_, depth, out);
     }
 
     void OrderBook::print_depth(int depth) const {
@@ -171,7 +236,7 @@ namespace marketsim::exchange::operations {
         for (size_t i = 0; i < max_levels; ++i) {
             // Bid side
             if (i < buy_levels.size()) {
-                std::cout << buy_levels[i].price << "\t" << static_cast<int>(buy_levels[i].total_quantity());
+                std::cout << buy_levels[i].price << "\t" << static_cast<int>(buy_levels[i].quantity);
             }
             else {
                 std::cout << "\t";
@@ -182,7 +247,7 @@ namespace marketsim::exchange::operations {
 
             // Ask side
             if (i < sell_levels.size()) {
-                std::cout << sell_levels[i].price << "\t" << static_cast<int>(sell_levels[i].total_quantity());
+                std::cout << sell_levels[i].price << "\t" << static_cast<int>(sell_levels[i].quantity);
             }
 
             std::cout << "\n";
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "price_level.h"
+#include "price_ladder.h"
+#include "order_pool.h"
+#include "exchange/utils/flat_hash_map.h"
 #include <vector>
-#include <map>
-#include <unordered_map>
 #include <string>
 #include <cstdint>
 #include <memory>
@@ -10,78 +12,93 @@
 namespace marketsim::exchange::operations {
 
     /**
-     * @brief Represents a single order in the order book
+     * @brief Running totals for one side of the book (remaining quantity only)
      */
-    struct OrderEntry {
-        std::string order_id;
-        std::string client_id;
-        double price;
-        double quantity;
-        double filled_quantity;
-        int64_t timestamp;
-
-        OrderEntry(const std::string& id, const std::string& client, double p, double q, int64_t ts)
-            : order_id(id), client_id(client), price(p), quantity(q),
-            filled_quantity(0), timestamp(ts) {
-        }
-
-        double remaining_quantity() const {
-            return quantity - filled_quantity;
-        }
-    };
-
-    /**
-     * @brief Single price level in order book
-     */
-    struct PriceLevel {
-        double price;
-        std::vector<OrderEntry> orders;  // FIFO queue at this price
-
-        explicit PriceLevel(double p) : price(p) {}
-
-        double total_quantity() const {
-            double total = 0;
-            for (const auto& order : orders) {
-                total += order.remaining_quantity();
-            }
-            return total;
-        }
+    struct SideTotals {
+        size_t order_count = 0;
+        double quantity = 0;
+        double notional = 0;   // Sum of price * remaining quantity
     };
 
     /**
      * @brief Order Book for a single symbol
      * Maintains separate buy and sell sides
+     *
+     * Prices are normalized to integer ticks of `tick_size` on entry; each side is
+     * an array-indexed PriceLadder covering `ladder_levels` ticks around the touch.
+     * Resting orders are pooled nodes linked into their level's FIFO queue, and the
+     * order-id map points straight at the node, so cancel/amend are O(1).
+     * Levels and sides keep running quantity/count/notional totals, so L1/L2 queries
+     * and book statistics never walk the queues.
      */
     class OrderBook {
     public:
-        explicit OrderBook(const std::string& symbol);
+        explicit OrderBook(const std::string& symbol, double tick_size = 0.01, size_t ladder_levels = 4096,
+                           size_t expected_orders = 1024);
 
         // Add order
         void add_order(const OrderEntry& order, bool is_buy);
 
         // Cancel order
-        bool cancel_order(const std::string& order_id, bool is_buy);
+        bool cancel_order(uint64_t order_id, bool is_buy);
+
+        // Amend order quantity. Decrease keeps queue priority, increase moves the
+        // order to the back of its level; reducing to <= filled cancels it.
+        bool amend_order(uint64_t order_id, double new_quantity);
+
+        // Resting order by id, nullptr if not in the book
+        const OrderEntry* find_order(uint64_t order_id) const;
 
         // Get best bid/ask
         bool get_best_bid(double& price, double& quantity) const;
         bool get_best_ask(double& price, double& quantity) const;
 
     // Get order book snapshot
-    std::vector<PriceLevel> get_buy_side(int depth = 10) const;
-    std::vector<PriceLevel> get_sell_side(int depth = 10) const;
+    std::vector<LevelSnapshot> get_buy_side(int depth = 10) const;
+    std::vector<LevelSnapshot> get_sell_side(int depth = 10) const;
+
+    // Same, into a caller-owned buffer (cleared first) so repeated queries don't allocate
+    void get_buy_side(int depth, std::vector<LevelSnapshot>& out) const;
+    void get_sell_side(int depth, std::vector<LevelSnapshot>& out) const;
+
+    // Direct access to best levels (for matching engine to modify in-place)
+    PriceLevel* best_bid_level() { return buy_side_.best(); }
+    PriceLevel* best_ask_level() { return sell_side_.best(); }
 
-    // Direct access to maps (for matching engine to modify in-place)
-    std::map<double, PriceLevel, std::greater<double>>& get_buy_side_map() { return buy_side_; }
-    std::map<double, PriceLevel, std::less<double>>& get_sell_side_map() { return sell_side_; }
+    // Remove an emptied price level
+    void remove_level(PriceTicks price_ticks, bool is_buy);
     
-    // Remove order from tracking map
-    void remove_order_from_map(const std::string& order_id) { order_price_map_.erase(order_id); }
+    // Fill `qty` of a resting order; returns true if it was fully filled and recycled
+    bool fill_order(PriceLevel& level, OrderEntry* order, double qty);
+
+    // Visit one side's resting orders in priority order: best level first, FIFO within a level
+    template<typename Visitor>
+    void for_each_order(bool is_buy, Visitor&& visit) const {
+        const PriceLadder& side = is_buy ? buy_side_ : sell_side_;
+        for (const PriceLevel* level = side.best(); level; level = side.next(level->price_ticks)) {
+            for (const OrderEntry* order = level->head; order; order = order->next) {
+                visit(*order);
+            }
+        }
+    }
+
+    // Tick conversion (to_ticks rounds to the nearest tick)
+    PriceTicks to_ticks(double price) const;
+    PriceTicks to_ticks_floor(double price) const;
+    PriceTicks to_ticks_ceil(double price) const;
+
+    // Off-grid limit onto the grid on its conservative side: buys down, sells up
+    PriceTicks to_limit_ticks(double price, bool is_buy) const;
+    double to_price(PriceTicks ticks) const { return static_cast<double>(ticks) * tick_size_; }
+    double tick_size() const { return tick_size_; }
 
     // Statistics
-        size_t total_buy_orders() const;
-        size_t total_sell_orders() const;
-        double total_buy_quantity() const;
-        double total_sell_quantity() const;
+        size_t total_buy_orders() const { return buy_totals_.order_count; }
+        size_t total_sell_orders() const { return sell_totals_.order_count; }
+        double total_buy_quantity() const { return buy_totals_.quantity; }
+        double total_sell_quantity() const { return sell_totals_.quantity; }
+        double total_buy_notional() const { return buy_totals_.notional; }
+        double total_sell_notional() const { return sell_totals_.notional; }
 
         const std::string& get_symbol() const { return symbol_; }
 
@@ -89,16 +106,30 @@ namespace marketsim::exchange::operations {
         void print_depth(int depth = 10) const;
 
     private:
+        void collect_levels(const PriceLadder& side, int depth, std::vector<LevelSnapshot>& out) const;
+
+        // Unlink order from its level, update totals and recycle the node
+        void remove_order(PriceLevel& level, OrderEntry* order);
+
+        SideTotals& totals_for(bool is_buy) { return is_buy ? buy_totals_ : sell_totals_; }
+
         std::string symbol_;
+        double tick_size_;
+
+        // Buy side: highest bid is best
+        PriceLadder buy_side_;
+
+        // Sell side: lowest ask is best
+        PriceLadder sell_side_;
 
-        // Buy side: price in descending order (highest bid first)
-        std::map<double, PriceLevel, std::greater<double>> buy_side_;
+        SideTotals buy_totals_;
+        SideTotals sell_totals_;
 
-        // Sell side: price in ascending order (lowest ask first)
-        std::map<double, PriceLevel, std::less<double>> sell_side_;
+        // Storage for resting order nodes (preallocated for expected_orders)
+        OrderPool pool_;
 
-        // Quick lookup for order cancellation
-        std::unordered_map<std::string, std::pair<double, bool>> order_price_map_;
+        // Quick lookup for order cancellation (flat, no per-order allocation)
+        utils::FlatHashMap<uint64_t, OrderEntry*> order_price_map_;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "exchange/utils/flat_hash_map.h"
+#include <string>
+#include <string_view>
+#include <deque>
+#include <vector>
+#include <cstdint>
+
+namespace marketsim::exchange::operations {
+
+    /**
+     * @brief Internal 64-bit order ids for resting orders, mapped to/from wire ids
+     *
+     * The book and matching loop only ever see the 64-bit id. The external string
+     * is kept in a recycled slot (low 32 bits of the id) and is only looked up when
+     * building a trade report or resolving a cancel/amend from the wire. The high
+     * 32 bits are a sequence number so ids are never reused. Not thread-safe.
+     */
+    class OrderIdMap {
+    public:
+        // Preallocate slots and index for `count` resting orders
+        void reserve(size_t count) {
+            ids_.reserve(count);
+            free_slots_.reserve(count);
+            size_t first = names_.size();
+            if (count <= first) {
+                return;
+            }
+            names_.resize(count);
+            // Pushed high-to-low so the lowest new slot is handed out first
+            for (size_t slot = count; slot-- > first;) {
+                free_slots_.push_back(static_cast<uint32_t>(slot));
+            }
+        }
+
+        // Register a resting order; a duplicate external id re-points to the new order
+        uint64_t assign(std::string_view external) {
+            ids_.erase(external);
+
+            uint32_t slot;
+            if (free_slots_.empty()) {
+                slot = static_cast<uint32_t>(names_.size());
+                names_.emplace_back();
+            }
+            else {
+                slot = free_slots_.back();
+                free_slots_.pop_back();
+            }
+
+            names_[slot].assign(external.data(), external.size());
+            uint64_t id = (++sequence_ << 32) | slot;
+            ids_.insert_or_assign(std::string_view(names_[slot]), id);
+            return id;
+        }
+
+        // Internal id for an external id of a resting order
+        bool find(std::string_view external, uint64_t& id) const {
+            const uint64_t* found = ids_.find(external);
+            if (!found) {
+                return false;
+            }
+            id = *found;
+            return true;
+        }
+
+        const std::string& external(uint64_t id) const { return names_[slot_of(id)]; }
+
+        // Forget an order once it leaves the book (filled or cancelled)
+        void release(uint64_t id) {
+            uint32_t slot = slot_of(id);
+            const uint64_t* found = ids_.find(names_[slot]);
+            if (found && *found == id) {
+                ids_.erase(names_[slot]);
+            }
+            free_slots_.push_back(slot);
+        }
+
+        size_t size() const { return names_.size() - free_slots_.size(); }
+
+    private:
+        static uint32_t slot_of(uint64_t id) { return static_cast<uint32_t>(id); }
+
+        // deque keeps slot addresses stable, so map keys can view into it;
+        // recycled slots keep their string capacity
+        std::deque<std::string> names_;
+        std::vector<uint32_t> free_slots_;
+        utils::FlatHashMap<std::string_view, uint64_t> ids_;
+        uint64_t sequence_ = 0;
+    };
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "price_level.h"
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+namespace marketsim::exchange::operations {
+
+    /**
+     * @brief Free-list pool of OrderEntry nodes
+     *
+     * Nodes are allocated in fixed-size chunks and recycled on cancel/fill,
+     * so resting orders do not hit the global allocator once the pool is warm.
+     * Not thread-safe (one per book).
+     */
+    class OrderPool {
+    public:
+        explicit OrderPool(size_t chunk_size = 1024)
+            : chunk_size_(chunk_size > 0 ? chunk_size : 1)
+            , free_list_(nullptr)
+            , in_use_(0)
+        {}
+
+        OrderPool(const OrderPool&) = delete;
+        OrderPool& operator=(const OrderPool&) = delete;
+
+        OrderEntry* acquire() {
+            if (!free_list_) {
+                grow();
+            }
+            OrderEntry* node = free_list_;
+            free_list_ = node->next;
+            node->prev = nullptr;
+            node->next = nullptr;
+            ++in_use_;
+            return node;
+        }
+
+        void release(OrderEntry* node) {
+            node->prev = nullptr;
+            node->next = free_list_;
+            free_list_ = node;
+            --in_use_;
+        }
+
+        // Preallocate so the first `count` resting orders never hit the allocator
+        void reserve(size_t count) {
+            while (capacity() < count) {
+                grow();
+            }
+        }
+
+        size_t in_use() const { return in_use_; }
+        size_t capacity() const { return chunks_.size() * chunk_size_; }
+
+    private:
+        void grow() {
+            chunks_.push_back(std::make_unique<OrderEntry[]>(chunk_size_));
+            OrderEntry* chunk = chunks_.back().get();
+            // Thread in reverse so nodes are handed out in address order
+            for (size_t i = chunk_size_; i-- > 0;) {
+                chunk[i].next = free_list_;
+                free_list_ = &chunk[i];
+            }
+        }
+
+        size_t chunk_size_;
+        std::vector<std::unique_ptr<OrderEntry[]>> chunks_;
+        OrderEntry* free_list_;   // Linked through OrderEntry::next
+        size_t in_use_;
+    };
+
+}
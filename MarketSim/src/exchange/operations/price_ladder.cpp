@@ -0,0 +1,306 @@
+#include "price_ladder.h"
+#include <algorithm>
+#include <bit>
+
+namespace marketsim::exchange::operations {
+
+    namespace {
+
+        constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+        // Mask with bits [0, bit] set
+        uint64_t mask_through(size_t bit) {
+            return bit == 63 ? ~uint64_t{0} : ((uint64_t{1} << (bit + 1)) - 1);
+        }
+
+        // Highest set bit index < limit in a flat bit vector
+        size_t scan_down(const std::vector<uint64_t>& words, size_t limit) {
+            if (limit == 0) {
+                return kNotFound;
+            }
+            size_t idx = limit - 1;
+            size_t w = idx >> 6;
+            uint64_t m = words[w] & mask_through(idx & 63);
+            while (true) {
+                if (m) {
+                    return (w << 6) + 63 - static_cast<size_t>(std::countl_zero(m));
+                }
+                if (w == 0) {
+                    return kNotFound;
+                }
+                m = words[--w];
+            }
+        }
+
+        // Lowest set bit index >= from in a flat bit vector
+        size_t scan_up(const std::vector<uint64_t>& words, size_t from) {
+            if (from >= words.size() * 64) {
+                return kNotFound;
+            }
+            size_t w = from >> 6;
+            uint64_t m = words[w] & (~uint64_t{0} << (from & 63));
+            while (true) {
+                if (m) {
+                    return (w << 6) + static_cast<size_t>(std::countr_zero(m));
+                }
+                if (++w == words.size()) {
+                    return kNotFound;
+                }
+                m = words[w];
+            }
+        }
+
+    }
+
+    PriceLadder::PriceLadder(Side side, size_t window_levels)
+        : side_(side)
+        , base_(0)
+        , window_count_(0)
+        , level_count_(0)
+    {
+        // Round up to whole bitmap words
+        size_t words = std::max<size_t>(1, (window_levels + 63) / 64);
+        levels_.resize(words * 64);
+        bits_.assign(words, 0);
+        summary_.assign((words + 63) / 64, 0);
+    }
+
+    void PriceLadder::set_bit(size_t idx) {
+        size_t w = idx >> 6;
+        bits_[w] |= uint64_t{1} << (idx & 63);
+        summary_[w >> 6] |= uint64_t{1} << (w & 63);
+    }
+
+    void PriceLadder::clear_bit(size_t idx) {
+        size_t w = idx >> 6;
+        bits_[w] &= ~(uint64_t{1} << (idx & 63));
+        if (bits_[w] == 0) {
+            summary_[w >> 6] &= ~(uint64_t{1} << (w & 63));
+        }
+    }
+
+    size_t PriceLadder::highest_below(size_t limit) const {
+        if (limit == 0) {
+            return npos;
+        }
+        size_t idx = limit - 1;
+        size_t w = idx >> 6;
+        uint64_t m = bits_[w] & mask_through(idx & 63);
+        if (m) {
+            return (w << 6) + 63 - static_cast<size_t>(std::countl_zero(m));
+        }
+
+        // Jump straight to the highest non-empty word below w
+        size_t sw = scan_down(summary_, w);
+        if (sw == kNotFound) {
+            return npos;
+        }
+        return (sw << 6) + 63 - static_cast<size_t>(std::countl_zero(bits_[sw]));
+    }
+
+    size_t PriceLadder::lowest_from(size_t from) const {
+        if (from >= levels_.size()) {
+            return npos;
+        }
+        size_t w = from >> 6;
+        uint64_t m = bits_[w] & (~uint64_t{0} << (from & 63));
+        if (m) {
+            return (w << 6) + static_cast<size_t>(std::countr_zero(m));
+        }
+
+        // Jump straight to the lowest non-empty word above w
+        size_t sw = scan_up(summary_, w + 1);
+        if (sw == kNotFound || sw >= bits_.size()) {
+            return npos;
+        }
+        return (sw << 6) + static_cast<size_t>(std::countr_zero(bits_[sw]));
+    }
+
+    PriceLevel* PriceLadder::find(PriceTicks ticks) {
+        if (in_window(ticks)) {
+            size_t idx = index_of(ticks);
+            if (bits_[idx >> 6] & (uint64_t{1} << (idx & 63))) {
+                return &levels_[idx];
+            }
+            return nullptr;
+        }
+
+        auto it = overflow_.find(ticks);
+        return it != overflow_.end() ? &it->second : nullptr;
+    }
+
+    PriceLevel& PriceLadder::get_or_create(PriceTicks ticks, double price) {
+        if (window_count_ == 0 || !in_window(ticks)) {
+            if (!recentre(ticks)) {
+                // Too far from the touch - park it in the overflow map
+                auto [it, inserted] = overflow_.try_emplace(ticks, ticks, price);
+                if (inserted) {
+                    ++level_count_;
+                }
+                return it->second;
+            }
+        }
+
+        size_t idx = index_of(ticks);
+        auto& level = levels_[idx];
+        if (!(bits_[idx >> 6] & (uint64_t{1} << (idx & 63)))) {
+            level.price = price;
+            level.price_ticks = ticks;
+            level.clear();
+            set_bit(idx);
+            ++window_count_;
+            ++level_count_;
+        }
+        return level;
+    }
+
+    void PriceLadder::erase(PriceTicks ticks) {
+        if (in_window(ticks)) {
+            size_t idx = index_of(ticks);
+            if (bits_[idx >> 6] & (uint64_t{1} << (idx & 63))) {
+                levels_[idx].clear();
+                clear_bit(idx);
+                --window_count_;
+                --level_count_;
+            }
+            return;
+        }
+
+        if (overflow_.erase(ticks) > 0) {
+            --level_count_;
+        }
+    }
+
+    PriceLevel* PriceLadder::window_best() const {
+        size_t idx = (side_ == Side::BID) ? highest_below(levels_.size()) : lowest_from(0);
+        return idx == npos ? nullptr : const_cast<PriceLevel*>(&levels_[idx]);
+    }
+
+    const PriceLevel* PriceLadder::overflow_best() const {
+        if (overflow_.empty()) {
+            return nullptr;
+        }
+        return (side_ == Side::BID) ? &overflow_.rbegin()->second : &overflow_.begin()->second;
+    }
+
+    PriceLevel* PriceLadder::best() {
+        return const_cast<PriceLevel*>(static_cast<const PriceLadder*>(this)->best());
+    }
+
+    const PriceLevel* PriceLadder::best() const {
+        const PriceLevel* in_win = window_best();
+        const PriceLevel* out_win = overflow_best();
+
+        if (!in_win) return out_win;
+        if (!out_win) return in_win;
+
+        if (side_ == Side::BID) {
+            return out_win->price_ticks > in_win->price_ticks ? out_win : in_win;
+        }
+        return out_win->price_ticks < in_win->price_ticks ? out_win : in_win;
+    }
+
+    const PriceLevel* PriceLadder::next(PriceTicks ticks) const {
+        const PriceLevel* in_win = nullptr;
+        const PriceLevel* out_win = nullptr;
+        PriceTicks width = static_cast<PriceTicks>(levels_.size());
+
+        if (side_ == Side::BID) {
+            // Highest populated level strictly below ticks
+            if (ticks > base_) {
+                size_t limit = static_cast<size_t>(std::min(ticks - base_, width));
+                size_t idx = highest_below(limit);
+                if (idx != npos) in_win = &levels_[idx];
+            }
+            auto it = overflow_.lower_bound(ticks);
+            if (it != overflow_.begin()) {
+                out_win = &std::prev(it)->second;
+            }
+
+            if (!in_win) return out_win;
+            if (!out_win) return in_win;
+            return out_win->price_ticks > in_win->price_ticks ? out_win : in_win;
+        }
+
+        // Lowest populated level strictly above ticks
+        if (ticks + 1 - base_ < width) {
+            size_t from = static_cast<size_t>(std::max<PriceTicks>(0, ticks + 1 - base_));
+            size_t idx = lowest_from(from);
+            if (idx != npos) in_win = &levels_[idx];
+        }
+        auto it = overflow_.upper_bound(ticks);
+        if (it != overflow_.end()) {
+            out_win = &it->second;
+        }
+
+        if (!in_win) return out_win;
+        if (!out_win) return in_win;
+        return out_win->price_ticks < in_win->price_ticks ? out_win : in_win;
+    }
+
+    bool PriceLadder::recentre(PriceTicks ticks) {
+        PriceTicks width = static_cast<PriceTicks>(levels_.size());
+
+        if (window_count_ == 0) {
+            base_ = ticks - width / 2;
+            pull_from_overflow();
+            return true;
+        }
+
+        PriceTicks lo = base_ + static_cast<PriceTicks>(lowest_from(0));
+        PriceTicks hi = base_ + static_cast<PriceTicks>(highest_below(levels_.size()));
+        PriceTicks new_lo = std::min(lo, ticks);
+        PriceTicks new_hi = std::max(hi, ticks);
+
+        if (new_hi - new_lo >= width) {
+            return false;
+        }
+
+        // Centre the populated range in the new window
+        PriceTicks new_base = new_lo - (width - (new_hi - new_lo + 1)) / 2;
+
+        // Slide the populated levels in place (no allocation), like memmove: walk
+        // them from the end they move towards, so none lands on one not yet moved
+        PriceTicks shift = base_ - new_base;
+        auto relocate = [this, shift](size_t idx) {
+            size_t to = static_cast<size_t>(static_cast<PriceTicks>(idx) + shift);
+            levels_[to] = std::move(levels_[idx]);
+            clear_bit(idx);
+            set_bit(to);
+        };
+
+        if (shift > 0) {
+            for (size_t idx = highest_below(levels_.size()); idx != npos; idx = highest_below(idx)) {
+                relocate(idx);
+            }
+        }
+        else if (shift < 0) {
+            for (size_t idx = lowest_from(0); idx != npos; idx = lowest_from(idx + 1)) {
+                relocate(idx);
+            }
+        }
+
+        base_ = new_base;
+        pull_from_overflow();
+        return true;
+    }
+
+    void PriceLadder::pull_from_overflow() {
+        if (overflow_.empty()) {
+            return;
+        }
+
+        PriceTicks width = static_cast<PriceTicks>(levels_.size());
+        auto it = overflow_.lower_bound(base_);
+        auto end = overflow_.lower_bound(base_ + width);
+
+        while (it != end) {
+            size_t idx = index_of(it->first);
+            levels_[idx] = std::move(it->second);
+            set_bit(idx);
+            ++window_count_;
+            it = overflow_.erase(it);
+        }
+    }
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "price_level.h"
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+
+namespace marketsim::exchange::operations {
+
+    /**
+     * @brief One side of the book as a contiguous, array-indexed ladder of price levels
+     *
+     * Levels inside a window of `window_levels` ticks live in a flat vector indexed by
+     * (price_ticks - base). A two-level occupancy bitmap (one bit per level, one summary
+     * bit per 64 levels) finds the best price and the next populated level with a couple
+     * of bit scans instead of a tree walk.
+     *
+     * The window follows the touch: when an order arrives outside it and the populated
+     * range still fits, the window is re-centred. Prices that cannot fit (far outliers)
+     * are kept in a small sorted overflow map so no order is ever rejected.
+     */
+    class PriceLadder {
+    public:
+        enum class Side {
+            BID,  // Best = highest price
+            ASK   // Best = lowest price
+        };
+
+        PriceLadder(Side side, size_t window_levels);
+
+        // Find level at price, nullptr if not populated
+        PriceLevel* find(PriceTicks ticks);
+
+        // Find or create level at price
+        PriceLevel& get_or_create(PriceTicks ticks, double price);
+
+        // Remove level at price (caller must have unlinked its orders)
+        void erase(PriceTicks ticks);
+
+        // Best level (highest bid / lowest ask), nullptr if side is empty
+        PriceLevel* best();
+        const PriceLevel* best() const;
+
+        // Next populated level behind `ticks` in priority order, nullptr if none
+        const PriceLevel* next(PriceTicks ticks) const;
+
+        size_t size() const { return level_count_; }
+        bool empty() const { return level_count_ == 0; }
+
+    private:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        bool in_window(PriceTicks ticks) const {
+            return ticks >= base_ && ticks < base_ + static_cast<PriceTicks>(levels_.size());
+        }
+
+        size_t index_of(PriceTicks ticks) const { return static_cast<size_t>(ticks - base_); }
+
+        void set_bit(size_t idx);
+        void clear_bit(size_t idx);
+
+        // Highest occupied index < limit / lowest occupied index >= from
+        size_t highest_below(size_t limit) const;
+        size_t lowest_from(size_t from) const;
+
+        // Move window so it covers `ticks`; false if populated range would not fit
+        bool recentre(PriceTicks ticks);
+        void pull_from_overflow();
+
+        PriceLevel* window_best() const;
+        const PriceLevel* overflow_best() const;
+
+        Side side_;
+        PriceTicks base_;
+
+        std::vector<PriceLevel> levels_;
+        std::vector<uint64_t> bits_;      // One bit per level
+        std::vector<uint64_t> summary_;   // One bit per non-zero word of bits_
+        size_t window_count_;
+
+        // Levels outside the window, sorted ascending by ticks
+        std::map<PriceTicks, PriceLevel> overflow_;
+        size_t level_count_;
+    };
+
+}
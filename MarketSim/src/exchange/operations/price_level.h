@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace marketsim::exchange::operations {
+
+    /**
+     * @brief Price expressed as an integer number of ticks
+     *
+     * All comparisons inside the book are done on ticks, so floating-point
+     * noise can never split one price into two levels.
+     */
+    using PriceTicks = int64_t;
+
+    /**
+     * @brief Represents a single order in the order book
+     *
+     * Ids are internal integers (see OrderIdMap and utils::InternTable); wire strings
+     * never enter the book. Also an intrusive list node: resting orders are linked into their
+     * PriceLevel's FIFO queue through prev/next, so unlinking is O(1).
+     */
+    struct OrderEntry {
+        uint64_t order_id;
+        uint32_t client_id;
+        double price;
+        PriceTicks price_ticks;
+        double quantity;
+        double filled_quantity;
+        int64_t timestamp;
+        bool is_buy;
+
+        // Intrusive FIFO links (owned by the PriceLevel)
+        OrderEntry* prev;
+        OrderEntry* next;
+
+        OrderEntry()
+            : order_id(0), client_id(0), price(0), price_ticks(0), quantity(0), filled_quantity(0), timestamp(0),
+            is_buy(false), prev(nullptr), next(nullptr) {
+        }
+
+        OrderEntry(uint64_t id, uint32_t client, double p, double q, int64_t ts)
+            : order_id(id), client_id(client), price(p), price_ticks(0), quantity(q),
+            filled_quantity(0), timestamp(ts), is_buy(false), prev(nullptr), next(nullptr) {
+        }
+
+        double remaining_quantity() const {
+            return quantity - filled_quantity;
+        }
+    };
+
+    /**
+     * @brief Single price level in order book
+     *
+     * FIFO queue of resting orders as an intrusive doubly-linked list.
+     * The level does not own the nodes; OrderBook allocates them from its OrderPool.
+     * Remaining quantity is kept as a running total, so depth queries never walk the queue.
+     */
+    struct PriceLevel {
+        double price;
+        PriceTicks price_ticks;
+        OrderEntry* head;   // Oldest order (matched first)
+        OrderEntry* tail;   // Newest order
+        size_t order_count;
+        double quantity;    // Sum of remaining quantity of all orders
+
+        PriceLevel() : price(0), price_ticks(0), head(nullptr), tail(nullptr), order_count(0), quantity(0) {}
+
+        PriceLevel(PriceTicks ticks, double p)
+            : price(p), price_ticks(ticks), head(nullptr), tail(nullptr), order_count(0), quantity(0) {}
+
+        bool empty() const { return head == nullptr; }
+        OrderEntry* front() const { return head; }
+
+        // Append order at back of queue (time priority)
+        void push_back(OrderEntry* order) {
+            order->prev = tail;
+            order->next = nullptr;
+            if (tail) {
+                tail->next = order;
+            }
+            else {
+                head = order;
+            }
+            tail = order;
+            ++order_count;
+            quantity += order->remaining_quantity();
+        }
+
+        // Unlink order from anywhere in the queue
+        void unlink(OrderEntry* order) {
+            if (order->prev) {
+                order->prev->next = order->next;
+            }
+            else {
+                head = order->next;
+            }
+            if (order->next) {
+                order->next->prev = order->prev;
+            }
+            else {
+                tail = order->prev;
+            }
+            order->prev = nullptr;
+            order->next = nullptr;
+            // Reset on empty so floating-point residue cannot accumulate
+            quantity = (--order_count == 0) ? 0 : quantity - order->remaining_quantity();
+        }
+
+        // Apply a fill to an order in this level
+        void fill(OrderEntry* order, double qty) {
+            order->filled_quantity += qty;
+            quantity -= qty;
+        }
+
+        void clear() {
+            head = nullptr;
+            tail = nullptr;
+            order_count = 0;
+            quantity = 0;
+        }
+
+        double total_quantity() const { return quantity; }
+        double notional() const { return quantity * price; }
+    };
+
+    /**
+     * @brief Aggregated view of a price level (for snapshots and display)
+     */
+    struct LevelSnapshot {
+        double price;
+        double quantity;
+        size_t order_count;
+    };
+
+}
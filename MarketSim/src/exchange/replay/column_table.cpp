@@ -0,0 +1,74 @@
+#include "column_table.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace marketsim::exchange::replay {
+
+ColumnTable::ColumnTable(const std::string& directory)
+    : directory_(directory)
+    , rows_(0)
+    , closed_(false)
+    , failed_(false)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        throw std::runtime_error("Cannot create output directory " + directory_ + ": " + ec.message());
+    }
+}
+
+ColumnTable::~ColumnTable() {
+    close();
+}
+
+void ColumnTable::end_row() {
+    ++rows_;
+    // All columns fill at the same row rate, so checking the first is enough
+    if (!columns_.empty() && columns_.front().buffer.size() >= kBlockBytes) {
+        for (auto& column : columns_) {
+            flush(column);
+        }
+    }
+}
+
+bool ColumnTable::flush(Column& column) {
+    std::string path = directory_ + "/" + column.name + ".bin";
+    std::FILE* file = std::fopen(path.c_str(), column.started ? "ab" : "wb");
+    bool ok = file && std::fwrite(column.buffer.data(), 1, column.buffer.size(), file) == column.buffer.size();
+    if (file) {
+        ok = std::fclose(file) == 0 && ok;
+    }
+    if (!ok && !failed_) {
+        std::cerr << "[REPLAY] Cannot write " << path << "\n";
+        failed_ = true;
+    }
+    column.started = true;
+    column.buffer.clear();
+    return ok;
+}
+
+bool ColumnTable::close() {
+    if (closed_) {
+        return !failed_;
+    }
+    closed_ = true;
+
+    for (auto& column : columns_) {
+        flush(column);
+    }
+
+    std::ofstream schema(directory_ + "/schema.txt");
+    schema << "rows " << rows_ << "\n";
+    for (const auto& column : columns_) {
+        schema << column.name << " " << column.dtype << "\n";
+    }
+    if (!schema) {
+        failed_ = true;
+    }
+    return !failed_;
+}
+
+} // namespace marketsim::exchange::replay
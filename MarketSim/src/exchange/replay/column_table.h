@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace marketsim::exchange::replay {
+
+/**
+ * @brief Append-only columnar table: one raw little-endian file per column
+ *
+ * `<directory>/<column>.bin` holds the column's values back to back, and
+ * `schema.txt` lists the columns with their numpy dtype and the row count, so
+ * a column loads with e.g. `numpy.fromfile("trades/price.bin", "<f8")`.
+ * Values are buffered per column and written in large blocks; a file is only
+ * open while a block is written, so many tables can be live at once.
+ *
+ * Usage: add_column() for each column, then per row one set() per column,
+ * then end_row(). Not thread-safe.
+ */
+class ColumnTable {
+public:
+    /**
+     * @brief Create directory (and parents); existing column files are replaced
+     * @throws std::runtime_error if it can't be created
+     */
+    explicit ColumnTable(const std::string& directory);
+
+    ~ColumnTable();
+
+    ColumnTable(const ColumnTable&) = delete;
+    ColumnTable& operator=(const ColumnTable&) = delete;
+
+    /**
+     * @brief Declare the next column (before the first row)
+     */
+    template<typename T>
+    void add_column(const std::string& name) {
+        static_assert(std::is_arithmetic_v<T>, "columns hold plain numbers");
+        columns_.push_back({ name, dtype<T>(), sizeof(T), {}, false });
+    }
+
+    /**
+     * @brief Set column `index` of the current row
+     */
+    template<typename T>
+    void set(size_t index, T value) {
+        Column& column = columns_[index];
+        size_t at = column.buffer.size();
+        column.buffer.resize(at + sizeof(T));
+        std::memcpy(column.buffer.data() + at, &value, sizeof(T));
+    }
+
+    /**
+     * @brief Finish the current row (flushes columns whose buffer is full)
+     */
+    void end_row();
+
+    /**
+     * @brief Write what is buffered and the schema (also done by the destructor)
+     * @return false if a write failed
+     */
+    bool close();
+
+    uint64_t rows() const { return rows_; }
+    const std::string& directory() const { return directory_; }
+
+private:
+    struct Column {
+        std::string name;
+        const char* dtype;
+        size_t width;
+        std::vector<char> buffer;
+        bool started;   // File created (later blocks append)
+    };
+
+    // Per column, before it is written out
+    static constexpr size_t kBlockBytes = 64 * 1024;
+
+    template<typename T>
+    static constexpr const char* dtype() {
+        if constexpr (std::is_same_v<T, double>) return "<f8";
+        else if constexpr (std::is_same_v<T, float>) return "<f4";
+        else if constexpr (std::is_same_v<T, int64_t>) return "<i8";
+        else if constexpr (std::is_same_v<T, uint64_t>) return "<u8";
+        else if constexpr (std::is_same_v<T, int32_t>) return "<i4";
+        else if constexpr (std::is_same_v<T, uint32_t>) return "<u4";
+        else if constexpr (std::is_same_v<T, uint8_t>) return "|u1";
+        else static_assert(sizeof(T) == 0, "unsupported column type");
+    }
+
+    bool flush(Column& column);
+
+    std::string directory_;
+    std::vector<Column> columns_;
+    uint64_t rows_;
+    bool closed_;
+    bool failed_;
+};
+
+} // namespace marketsim::exchange::replay
@@ -0,0 +1,170 @@
+#include "order_file.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace marketsim::exchange::replay {
+
+namespace {
+
+struct OrderFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_bytes;
+};
+
+static_assert(sizeof(OrderFileHeader) == 16, "order file header layout is part of the file format");
+
+constexpr char kOrderFileMagic[8] = { 'M', 'S', 'O', 'R', 'D', 'E', 'R', '1' };
+constexpr uint32_t kOrderFileVersion = 1;
+
+constexpr size_t align8(size_t n) {
+    return (n + 7) & ~size_t{7};
+}
+
+bool header_valid(const OrderFileHeader& header) {
+    return std::memcmp(header.magic, kOrderFileMagic, sizeof(kOrderFileMagic)) == 0 &&
+           header.version == kOrderFileVersion && header.header_bytes == sizeof(OrderFileHeader);
+}
+
+}
+
+// ============================================================================
+// OrderFileWriter
+// ============================================================================
+
+OrderFileWriter::OrderFileWriter(const std::string& path)
+    : out_(path, std::ios::binary | std::ios::trunc)
+    , sequence_(0)
+{
+    if (!out_) {
+        throw std::runtime_error("Cannot create order file " + path + ": " + std::strerror(errno));
+    }
+
+    OrderFileHeader header;
+    std::memcpy(header.magic, kOrderFileMagic, sizeof(kOrderFileMagic));
+    header.version = kOrderFileVersion;
+    header.header_bytes = sizeof(OrderFileHeader);
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+OrderFileWriter::~OrderFileWriter() {
+    close();
+}
+
+bool OrderFileWriter::write(repository::JournalRecordType type, const google::protobuf::MessageLite& message,
+                            int64_t timestamp_ns) {
+    if (!out_.is_open()) {
+        return false;
+    }
+
+    // Header, payload and padding built in one buffer, written with one call
+    size_t length = message.ByteSizeLong();
+    buffer_.assign(align8(sizeof(repository::JournalRecordHeader) + length), '\0');
+    auto* payload = reinterpret_cast<uint8_t*>(buffer_.data() + sizeof(repository::JournalRecordHeader));
+    message.SerializeWithCachedSizesToArray(payload);
+
+    repository::JournalRecordHeader header;
+    header.length = static_cast<uint32_t>(length);
+    header.crc = 0;
+    header.sequence = sequence_ + 1;
+    header.timestamp_ns = timestamp_ns;
+    header.type = static_cast<uint32_t>(type);
+    header.reserved = 0;
+    header.crc = repository::crc32c(repository::crc32c(0, &header, sizeof(header)), payload, length);
+    std::memcpy(buffer_.data(), &header, sizeof(header));
+
+    if (!out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()))) {
+        return false;
+    }
+    ++sequence_;
+    return true;
+}
+
+void OrderFileWriter::close() {
+    if (out_.is_open()) {
+        out_.close();
+    }
+}
+
+// ============================================================================
+// OrderFileReader
+// ============================================================================
+
+OrderFileReader::OrderFileReader(const std::string& path)
+    : base_(nullptr)
+    , size_(0)
+    , offset_(sizeof(OrderFileHeader))
+    , torn_records_(0)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open order file " + path + ": " + std::strerror(errno));
+    }
+    off_t size = ::lseek(fd, 0, SEEK_END);
+    if (size >= static_cast<off_t>(sizeof(OrderFileHeader))) {
+        void* base = ::mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base != MAP_FAILED) {
+            base_ = static_cast<const uint8_t*>(base);
+            size_ = static_cast<size_t>(size);
+#ifdef MADV_SEQUENTIAL
+            ::madvise(base, size_, MADV_SEQUENTIAL);  // Read once, front to back
+#endif
+        }
+    }
+    ::close(fd);  // The mapping keeps the file
+
+    OrderFileHeader header;
+    if (base_) {
+        std::memcpy(&header, base_, sizeof(header));
+    }
+    if (!base_ || !header_valid(header)) {
+        if (base_) {
+            ::munmap(const_cast<uint8_t*>(base_), size_);
+        }
+        throw std::runtime_error("Not an order file: " + path);
+    }
+}
+
+OrderFileReader::~OrderFileReader() {
+    ::munmap(const_cast<uint8_t*>(base_), size_);
+}
+
+bool OrderFileReader::next(repository::JournalRecord& record) {
+    repository::JournalRecordHeader header;
+    if (size_ - offset_ < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, base_ + offset_, sizeof(header));
+
+    const uint8_t* payload = base_ + offset_ + sizeof(header);
+    repository::JournalRecordHeader unsigned_header = header;
+    unsigned_header.crc = 0;
+    if (header.length > size_ - offset_ - sizeof(header) ||
+        repository::crc32c(repository::crc32c(0, &unsigned_header, sizeof(unsigned_header)),
+                           payload, header.length) != header.crc) {
+        torn_records_ = 1;  // Cut short or damaged: nothing after it is trusted
+        offset_ = size_;
+        return false;
+    }
+
+    offset_ = std::min(size_, offset_ + align8(sizeof(header) + header.length));
+    record.sequence = header.sequence;
+    record.timestamp_ns = header.timestamp_ns;
+    record.type = static_cast<repository::JournalRecordType>(header.type);
+    record.payload = std::string_view(reinterpret_cast<const char*>(payload), header.length);
+    return true;
+}
+
+bool is_order_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    OrderFileHeader header;
+    return in.read(reinterpret_cast<char*>(&header), sizeof(header)) && header_valid(header);
+}
+
+} // namespace marketsim::exchange::replay
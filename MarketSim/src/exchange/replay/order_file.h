@@ -0,0 +1,98 @@
+#pragma once
+
+#include "exchange/repository/order_repository.h"
+#include <google/protobuf/message_lite.h>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+namespace marketsim::exchange::replay {
+
+/**
+ * @brief Writes a binary order file for offline replay
+ *
+ * An order file is a 16-byte header (`MSORDER1`) followed by records framed
+ * exactly like the order journal's (repository::JournalRecordHeader, CRC-32C,
+ * 8-byte padding), back to back. Anything that can produce orders - a
+ * generator, a converter, a test - can record a flow once and replay it at
+ * full speed with marketsim_replay.
+ */
+class OrderFileWriter {
+public:
+    /**
+     * @brief Create (or truncate) path and write the file header
+     * @throws std::runtime_error if the file can't be created
+     */
+    explicit OrderFileWriter(const std::string& path);
+
+    ~OrderFileWriter();
+
+    OrderFileWriter(const OrderFileWriter&) = delete;
+    OrderFileWriter& operator=(const OrderFileWriter&) = delete;
+
+    /**
+     * @brief Append one Order or OrderBatch
+     * @param timestamp_ns Time the replay will stamp it with (ns since epoch)
+     * @return false if the write failed
+     */
+    bool write(repository::JournalRecordType type, const google::protobuf::MessageLite& message,
+               int64_t timestamp_ns);
+
+    /**
+     * @brief Flush and close (also done by the destructor)
+     */
+    void close();
+
+    uint64_t records() const { return sequence_; }
+
+private:
+    std::ofstream out_;
+    std::string buffer_;   // Reused serialization buffer
+    uint64_t sequence_;
+};
+
+/**
+ * @brief Sequential reader over an order file
+ *
+ * The file is mapped read-only; payloads point into the mapping and stay
+ * valid until the reader is destroyed. Reading stops at the first torn or
+ * corrupt record.
+ */
+class OrderFileReader {
+public:
+    /**
+     * @brief Map path
+     * @throws std::runtime_error if it can't be opened or isn't an order file
+     */
+    explicit OrderFileReader(const std::string& path);
+
+    ~OrderFileReader();
+
+    OrderFileReader(const OrderFileReader&) = delete;
+    OrderFileReader& operator=(const OrderFileReader&) = delete;
+
+    /**
+     * @brief Read the next record
+     * @return false at the end of the file (or of its intact part)
+     */
+    bool next(repository::JournalRecord& record);
+
+    // 1 if reading stopped at a damaged record
+    size_t torn_records() const { return torn_records_; }
+
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* base_;
+    size_t size_;
+    size_t offset_;
+    size_t torn_records_;
+};
+
+/**
+ * @brief Does path look like an order file (by its header)?
+ */
+bool is_order_file(const std::string& path);
+
+} // namespace marketsim::exchange::replay
@@ -0,0 +1,312 @@
+#include "replay_engine.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <limits>
+
+namespace marketsim::exchange::replay {
+
+namespace {
+
+// Requests moved per ring push/pop
+constexpr size_t kBatchSize = 64;
+
+enum TradeColumn : size_t {
+    TRADE_SEQUENCE,      // Per-symbol trade sequence
+    TRADE_TIMESTAMP_NS,
+    TRADE_PRICE,
+    TRADE_QUANTITY,
+    TRADE_AGGRESSOR_BUY, // 1 if the taker bought
+    TRADE_RECORD         // Sequence of the input record that caused it
+};
+
+enum BookColumn : size_t {
+    BOOK_RECORD,
+    BOOK_TIMESTAMP_NS,
+    BOOK_BID,            // NaN when the side is empty
+    BOOK_BID_QUANTITY,
+    BOOK_ASK,
+    BOOK_ASK_QUANTITY,
+    BOOK_BUY_ORDERS,
+    BOOK_SELL_ORDERS,
+    BOOK_BUY_QUANTITY,
+    BOOK_SELL_QUANTITY
+};
+
+// `symbol` (field 2 of both Order and OrderBatch) without decoding the rest;
+// writers emit fields in number order, so it is found right after the id
+bool peek_symbol(const char* payload, uint32_t size, std::string& symbol) {
+    using google::protobuf::internal::WireFormatLite;
+    constexpr uint32_t kSymbolTag = (2 << 3) | WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+
+    google::protobuf::io::CodedInputStream in(reinterpret_cast<const uint8_t*>(payload), static_cast<int>(size));
+    while (uint32_t tag = in.ReadTag()) {
+        if (tag == kSymbolTag) {
+            uint32_t length;
+            return in.ReadVarint32(&length) && in.ReadString(&symbol, static_cast<int>(length));
+        }
+        if (!WireFormatLite::SkipField(&in, tag)) {
+            return false;
+        }
+    }
+    symbol.clear();  // Not set
+    return true;
+}
+
+// Symbol as a directory name
+std::string path_safe(const std::string& symbol) {
+    std::string name = symbol.empty() ? "_" : symbol;
+    for (char& c : name) {
+        bool safe = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+                    c == '-' || c == '_' || c == '.';
+        if (!safe) {
+            c = '_';
+        }
+    }
+    return name;
+}
+
+}
+
+ReplayEngine::Worker::Worker(size_t queue_capacity)
+    : ring(queue_capacity)
+{
+    outbox.reserve(kBatchSize);
+    pending.resize(kBatchSize);
+}
+
+ReplayEngine::ReplayEngine(const ReplayOptions& options)
+    : options_(options)
+    , records_(0)
+    , started_(std::chrono::steady_clock::now())
+    , finished_(false)
+{
+    // Without threads the single worker is driven inline by submit()
+    size_t count = std::max<size_t>(options_.threads, 1);
+    for (size_t i = 0; i < count; ++i) {
+        workers_.push_back(std::make_unique<Worker>(options_.threads > 0 ? options_.queue_capacity : 1));
+    }
+    if (options_.threads > 0) {
+        for (auto& worker : workers_) {
+            worker->thread = std::make_unique<std::thread>(&ReplayEngine::run, this, std::ref(*worker));
+        }
+    }
+}
+
+ReplayEngine::~ReplayEngine() {
+    finish();
+}
+
+void ReplayEngine::submit(const repository::JournalRecord& record) {
+    ++records_;
+    Request request;
+    request.payload = record.payload.data();
+    request.size = static_cast<uint32_t>(record.payload.size());
+    request.type = record.type;
+    request.sequence = record.sequence;
+    request.timestamp_ns = record.timestamp_ns;
+
+    if (options_.threads == 0) {
+        apply(*workers_.front(), request);
+        return;
+    }
+
+    // Undecodable records go anywhere; the worker counts them
+    size_t index = 0;
+    if (peek_symbol(request.payload, request.size, symbol_)) {
+        index = std::hash<std::string>{}(symbol_) % workers_.size();
+    }
+    Worker& worker = *workers_[index];
+    worker.outbox.push_back(request);
+    if (worker.outbox.size() == kBatchSize) {
+        worker.ring.push_batch(worker.outbox.data(), worker.outbox.size());
+        worker.outbox.clear();
+    }
+}
+
+void ReplayEngine::run(Worker& worker) {
+    while (true) {
+        size_t count = worker.ring.pop_batch_for(worker.pending.data(), worker.pending.size(),
+                                                 std::chrono::milliseconds(100));
+        if (count == 0) {
+            if (worker.ring.is_stopped() && worker.ring.empty()) {
+                return;
+            }
+            continue;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            apply(worker, worker.pending[i]);
+        }
+    }
+}
+
+ReplayEngine::SymbolState& ReplayEngine::get_or_create_symbol(Worker& worker, const std::string& symbol) {
+    utils::InternId id = worker.symbol_ids.intern(symbol);
+    if (id < worker.symbols.size()) {
+        return *worker.symbols[id];
+    }
+
+    auto state = std::make_unique<SymbolState>();
+    state->engine = std::make_unique<operations::MatchingEngine>(
+        symbol, 100, options_.tick_size, options_.ladder_levels, options_.expected_orders);
+
+    if (!options_.output_directory.empty()) {
+        auto base = std::filesystem::path(options_.output_directory) / path_safe(symbol);
+
+        state->trades = std::make_unique<ColumnTable>((base / "trades").string());
+        state->trades->add_column<uint64_t>("trade_sequence");
+        state->trades->add_column<int64_t>("timestamp_ns");
+        state->trades->add_column<double>("price");
+        state->trades->add_column<double>("quantity");
+        state->trades->add_column<uint8_t>("aggressor_buy");
+        state->trades->add_column<uint64_t>("record");
+
+        if (options_.book_every > 0) {
+            state->book = std::make_unique<ColumnTable>((base / "book").string());
+            state->book->add_column<uint64_t>("record");
+            state->book->add_column<int64_t>("timestamp_ns");
+            state->book->add_column<double>("bid");
+            state->book->add_column<double>("bid_quantity");
+            state->book->add_column<double>("ask");
+            state->book->add_column<double>("ask_quantity");
+            state->book->add_column<uint64_t>("buy_orders");
+            state->book->add_column<uint64_t>("sell_orders");
+            state->book->add_column<double>("buy_quantity");
+            state->book->add_column<double>("sell_quantity");
+        }
+    }
+
+    worker.symbols.push_back(std::move(state));
+    return *worker.symbols.back();
+}
+
+void ReplayEngine::apply(Worker& worker, const Request& request) {
+    // Recorded time, never the clock (0 would mean "use the clock")
+    int64_t now_ns = std::max<int64_t>(request.timestamp_ns, 1);
+    auto size = static_cast<int>(request.size);
+    worker.fills.clear();
+
+    if (request.type == repository::JournalRecordType::ORDER && worker.order.ParseFromArray(request.payload, size)) {
+        SymbolState& state = get_or_create_symbol(worker, worker.order.symbol());
+        state.engine->set_time(now_ns);
+        auto result = state.engine->match_order(worker.order, worker.fills);
+        ++state.orders;
+        state.rejected += result.success ? 0 : 1;
+        record_output(state, worker.fills, request);
+        return;
+    }
+
+    if (request.type == repository::JournalRecordType::BATCH && worker.batch.ParseFromArray(request.payload, size)) {
+        if (worker.batch.orders_size() == 0) {
+            return;
+        }
+        SymbolState& state = get_or_create_symbol(worker, worker.batch.symbol());
+        state.engine->set_time(now_ns);
+        state.engine->match_batch(
+            { worker.batch.orders().data(), static_cast<size_t>(worker.batch.orders_size()) },
+            worker.fills, worker.results);
+        state.orders += worker.batch.orders_size();
+        for (const auto& result : worker.results) {
+            state.rejected += result.success ? 0 : 1;
+        }
+        record_output(state, worker.fills, request);
+        return;
+    }
+
+    ++worker.undecodable;
+}
+
+void ReplayEngine::record_output(SymbolState& state, const std::vector<operations::Fill>& fills,
+                                 const Request& request) {
+    ++state.requests;
+    const auto& book = state.engine->get_order_book();
+
+    if (state.trades) {
+        ColumnTable& trades = *state.trades;
+        for (const auto& fill : fills) {
+            trades.set(TRADE_SEQUENCE, fill.trade_seq);
+            trades.set(TRADE_TIMESTAMP_NS, fill.timestamp);
+            trades.set(TRADE_PRICE, book.to_price(fill.price_ticks));
+            trades.set(TRADE_QUANTITY, fill.quantity);
+            trades.set(TRADE_AGGRESSOR_BUY, static_cast<uint8_t>(fill.aggressor_is_buy ? 1 : 0));
+            trades.set(TRADE_RECORD, request.sequence);
+            trades.end_row();
+        }
+    }
+
+    if (state.book && state.requests % options_.book_every == 0) {
+        constexpr double kNone = std::numeric_limits<double>::quiet_NaN();
+        double bid = kNone, bid_qty = 0.0, ask = kNone, ask_qty = 0.0;
+        book.get_best_bid(bid, bid_qty);
+        book.get_best_ask(ask, ask_qty);
+
+        ColumnTable& rows = *state.book;
+        rows.set(BOOK_RECORD, request.sequence);
+        rows.set(BOOK_TIMESTAMP_NS, request.timestamp_ns);
+        rows.set(BOOK_BID, bid);
+        rows.set(BOOK_BID_QUANTITY, bid_qty);
+        rows.set(BOOK_ASK, ask);
+        rows.set(BOOK_ASK_QUANTITY, ask_qty);
+        rows.set(BOOK_BUY_ORDERS, static_cast<uint64_t>(book.total_buy_orders()));
+        rows.set(BOOK_SELL_ORDERS, static_cast<uint64_t>(book.total_sell_orders()));
+        rows.set(BOOK_BUY_QUANTITY, book.total_buy_quantity());
+        rows.set(BOOK_SELL_QUANTITY, book.total_sell_quantity());
+        rows.end_row();
+    }
+}
+
+ReplayStats ReplayEngine::finish() {
+    ReplayStats stats;
+    if (!finished_) {
+        finished_ = true;
+        for (auto& worker : workers_) {
+            if (!worker->outbox.empty()) {
+                worker->ring.push_batch(worker->outbox.data(), worker->outbox.size());
+                worker->outbox.clear();
+            }
+            worker->ring.stop();
+        }
+        for (auto& worker : workers_) {
+            if (worker->thread && worker->thread->joinable()) {
+                worker->thread->join();
+            }
+        }
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_).count();
+    stats.records = records_;
+
+    for (auto& worker : workers_) {
+        stats.rejected += worker->undecodable;
+        for (size_t id = 0; id < worker->symbols.size(); ++id) {
+            SymbolState& state = *worker->symbols[id];
+            if (state.trades) {
+                state.trades->close();
+            }
+            if (state.book) {
+                state.book->close();
+            }
+
+            const auto& book = state.engine->get_order_book();
+            ReplaySymbolStats symbol;
+            symbol.symbol = worker->symbol_ids.name(static_cast<utils::InternId>(id));
+            symbol.orders = state.orders;
+            symbol.rejected = state.rejected;
+            symbol.trades = state.engine->total_trades();
+            symbol.volume = state.engine->total_volume();
+            symbol.resting = book.total_buy_orders() + book.total_sell_orders();
+
+            stats.orders += symbol.orders;
+            stats.rejected += symbol.rejected;
+            stats.trades += symbol.trades;
+            stats.volume += symbol.volume;
+            stats.symbols.push_back(std::move(symbol));
+        }
+    }
+    std::sort(stats.symbols.begin(), stats.symbols.end(),
+              [](const ReplaySymbolStats& a, const ReplaySymbolStats& b) { return a.symbol < b.symbol; });
+    return stats;
+}
+
+} // namespace marketsim::exchange::replay
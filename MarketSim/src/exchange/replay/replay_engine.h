@@ -0,0 +1,148 @@
+#pragma once
+
+#include "column_table.h"
+#include "common/concurrency/spsc_ring.h"
+#include "exchange/operations/matching_engine.h"
+#include "exchange/repository/order_repository.h"
+#include "exchange/utils/intern_table.h"
+#include "exchange.pb.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace marketsim::exchange::replay {
+
+/**
+ * @brief How a replay is run and what it writes
+ */
+struct ReplayOptions {
+    std::string output_directory;   // Columnar trades/book states per symbol (empty = none)
+    size_t threads = 0;             // Matching threads, symbols hashed across them (0 = match on the caller)
+    size_t book_every = 1;          // Book state row after every Nth request of a symbol (0 = none)
+    double tick_size = 0.01;
+    size_t ladder_levels = 4096;
+    size_t expected_orders = 16384; // Resting order nodes preallocated per symbol
+    size_t queue_capacity = 16384;  // Requests buffered per matching thread
+};
+
+/**
+ * @brief Outcome for one symbol
+ */
+struct ReplaySymbolStats {
+    std::string symbol;
+    uint64_t orders = 0;
+    uint64_t rejected = 0;
+    uint64_t trades = 0;
+    double volume = 0;
+    size_t resting = 0;     // Orders left in the book
+};
+
+/**
+ * @brief Totals for a whole replay
+ */
+struct ReplayStats {
+    uint64_t records = 0;   // Orders and batches read
+    uint64_t orders = 0;
+    uint64_t rejected = 0;  // Includes records that didn't decode
+    uint64_t trades = 0;
+    double volume = 0;
+    double seconds = 0;     // Elapsed time from construction to finish()
+    std::vector<ReplaySymbolStats> symbols;
+};
+
+/**
+ * @brief Drives recorded order flow through one MatchingEngine per symbol
+ *
+ * Records (journal or order file) go in through submit() in their recorded
+ * order. There are no sockets and no clock reads: each engine's time is set
+ * from the record's timestamp, so fills and price histories carry recorded
+ * time and the same input always produces the same trades.
+ *
+ * With `threads` > 0, symbols are hashed across that many matching threads
+ * (as the exchange shards them); the caller only peeks at each record's
+ * symbol and hands the undecoded payload over an SPSC ring, so decoding and
+ * matching both scale with threads. Per-symbol order is kept, which is all
+ * matching depends on.
+ *
+ * With an output directory, each symbol gets `<dir>/<symbol>/trades/` and
+ * `<dir>/<symbol>/book/` ColumnTables.
+ */
+class ReplayEngine {
+public:
+    explicit ReplayEngine(const ReplayOptions& options);
+
+    ~ReplayEngine();
+
+    ReplayEngine(const ReplayEngine&) = delete;
+    ReplayEngine& operator=(const ReplayEngine&) = delete;
+
+    /**
+     * @brief Replay one record (its payload must stay valid until finish())
+     */
+    void submit(const repository::JournalRecord& record);
+
+    /**
+     * @brief Drain the matching threads, close the output and collect totals
+     */
+    ReplayStats finish();
+
+private:
+    // A record on its way to a matching thread (payload not decoded yet)
+    struct Request {
+        const char* payload = nullptr;
+        uint32_t size = 0;
+        repository::JournalRecordType type = repository::JournalRecordType::ORDER;
+        uint64_t sequence = 0;
+        int64_t timestamp_ns = 0;
+    };
+
+    struct SymbolState {
+        std::unique_ptr<operations::MatchingEngine> engine;
+        std::unique_ptr<ColumnTable> trades;
+        std::unique_ptr<ColumnTable> book;
+        uint64_t requests = 0;
+        uint64_t orders = 0;
+        uint64_t rejected = 0;
+    };
+
+    // Engines for a group of symbols and everything needed to run them
+    struct Worker {
+        explicit Worker(size_t queue_capacity);
+
+        common::concurrency::SpscRing<Request> ring;
+        utils::InternTable symbol_ids;
+        std::vector<std::unique_ptr<SymbolState>> symbols;
+
+        // Reused decode targets and match buffers
+        Order order;
+        OrderBatch batch;
+        std::vector<operations::Fill> fills;
+        std::vector<operations::OrderResult> results;
+        std::vector<Request> outbox;    // Filled by submit(), pushed in batches
+        std::vector<Request> pending;   // Popped by the matching thread
+        uint64_t undecodable = 0;
+
+        std::unique_ptr<std::thread> thread;
+    };
+
+    void run(Worker& worker);
+    void apply(Worker& worker, const Request& request);
+    SymbolState& get_or_create_symbol(Worker& worker, const std::string& symbol);
+
+    // Trade and book state rows for what the last request did
+    void record_output(SymbolState& state, const std::vector<operations::Fill>& fills,
+                       const Request& request);
+
+    ReplayOptions options_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::string symbol_;    // Scratch for routing
+    uint64_t records_;
+    std::chrono::steady_clock::time_point started_;
+    bool finished_;
+};
+
+} // namespace marketsim::exchange::replay
@@ -0,0 +1,609 @@
+#include "order_repository.h"
+#include "monitor/monitor_helpers.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+namespace marketsim::exchange::repository {
+
+namespace {
+
+// Segment file header; records start right after it
+struct SegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_bytes;
+    uint64_t first_sequence;   // 0 until the writer starts using the segment
+    uint64_t segment_bytes;
+    uint8_t reserved[32];
+};
+
+static_assert(sizeof(SegmentHeader) == 64, "segment header layout is part of the file format");
+
+constexpr char kSegmentMagic[8] = { 'M', 'S', 'J', 'O', 'U', 'R', 'N', '1' };
+constexpr uint32_t kSegmentVersion = 1;
+constexpr size_t kMinSegmentBytes = 64 * 1024;
+constexpr const char* kSegmentPrefix = "orders-";
+constexpr const char* kSegmentSuffix = ".wal";
+
+constexpr size_t align8(size_t n) {
+    return (n + 7) & ~size_t{7};
+}
+
+size_t page_size() {
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+std::string segment_path(const std::string& directory, uint32_t index) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%s%08u%s", kSegmentPrefix, index, kSegmentSuffix);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+// Index from "orders-<index>.wal", or 0 if the name doesn't match
+uint32_t segment_index(const std::string& name) {
+    std::string_view view(name);
+    std::string_view prefix(kSegmentPrefix);
+    std::string_view suffix(kSegmentSuffix);
+    if (view.size() <= prefix.size() + suffix.size() ||
+        view.substr(0, prefix.size()) != prefix ||
+        view.substr(view.size() - suffix.size()) != suffix) {
+        return 0;
+    }
+
+    uint32_t index = 0;
+    for (char c : view.substr(prefix.size(), view.size() - prefix.size() - suffix.size())) {
+        if (c < '0' || c > '9') {
+            return 0;
+        }
+        index = index * 10 + static_cast<uint32_t>(c - '0');
+    }
+    return index;
+}
+
+#if !defined(__SSE4_2__)
+// Slicing-by-8: table[k][b] is the CRC of byte b followed by k zero bytes
+constexpr std::array<std::array<uint32_t, 256>, 8> make_crc32c_tables() {
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78u : crc >> 1;
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (size_t k = 1; k < 8; ++k) {
+            tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr auto kCrc32cTables = make_crc32c_tables();
+#endif
+
+// Does the record at `at` (with `available` bytes behind it) pass its CRC?
+bool record_valid(const JournalRecordHeader& header, const uint8_t* at, size_t available) {
+    if (header.length > available - sizeof(JournalRecordHeader)) {
+        return false;
+    }
+    JournalRecordHeader unsigned_header = header;
+    unsigned_header.crc = 0;
+    uint32_t crc = crc32c(0, &unsigned_header, sizeof(unsigned_header));
+    return crc32c(crc, at + sizeof(JournalRecordHeader), header.length) == header.crc;
+}
+
+}
+
+uint32_t crc32c(uint32_t crc, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+#if defined(__SSE4_2__)
+    // One instruction per 8 bytes
+    uint64_t crc64 = crc;
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        bytes += 8;
+        size -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+    while (size-- > 0) {
+        crc = _mm_crc32_u8(crc, *bytes++);
+    }
+#else
+    // Eight bytes per step through independent table lookups
+    const auto& t = kCrc32cTables;
+    while (size >= 8) {
+        uint32_t lo;
+        uint32_t hi;
+        std::memcpy(&lo, bytes, sizeof(lo));
+        std::memcpy(&hi, bytes + 4, sizeof(hi));
+        lo ^= crc;
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        bytes += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = t[0][(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+    }
+#endif
+    return ~crc;
+}
+
+// ============================================================================
+// OrderRepository
+// ============================================================================
+
+OrderRepository::OrderRepository(const JournalOptions& options)
+    : options_(options)
+    , next_sequence_(1)
+    , published_offset_(sizeof(SegmentHeader))
+    , published_sequence_(0)
+    , append_failures_(0)
+    , next_index_(1)
+    , flush_requested_(false)
+    , flush_failing_(false)
+    , durable_sequence_(0)
+    , running_(false)
+{
+    // Whole pages, so every segment maps and msyncs cleanly
+    size_t page = page_size();
+    options_.segment_bytes = std::max(options_.segment_bytes, kMinSegmentBytes);
+    options_.segment_bytes = (options_.segment_bytes + page - 1) / page * page;
+    if (options_.flush_interval_ms <= 0) {
+        options_.flush_interval_ms = 1;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(options_.directory, ec);
+    if (ec) {
+        throw std::runtime_error("Cannot create journal directory " + options_.directory + ": " + ec.message());
+    }
+
+    // Continue after whatever an earlier run left (only the newest segment is read)
+    {
+        JournalReader existing(options_.directory, UINT64_MAX);
+        JournalRecord record;
+        while (existing.next(record)) {}
+        next_sequence_ = existing.last_sequence() + 1;
+        next_index_ = existing.last_segment_index() + 1;
+    }
+
+    active_ = create_segment(next_index_++);
+    if (!active_) {
+        throw std::runtime_error("Cannot create journal segment in " + options_.directory);
+    }
+    reinterpret_cast<SegmentHeader*>(active_->base)->first_sequence = next_sequence_;
+    active_->write_offset = sizeof(SegmentHeader);
+
+    published_sequence_.store(next_sequence_ - 1, std::memory_order_relaxed);
+    durable_sequence_.store(next_sequence_ - 1, std::memory_order_relaxed);
+}
+
+OrderRepository::~OrderRepository() {
+    stop();
+
+    // Segments whose final msync kept failing (their data is in the page cache only)
+    for (auto& segment : retired_) {
+        close_segment(*segment);
+    }
+    close_segment(*active_);
+    if (spare_) {
+        // Never used: leave no empty segment behind
+        close_segment(*spare_);
+        ::unlink(segment_path(options_.directory, spare_->index).c_str());
+    }
+}
+
+void OrderRepository::start() {
+    if (running_) {
+        return;
+    }
+
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&OrderRepository::run, this);
+}
+
+void OrderRepository::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    flush_cv_.notify_all();
+    durable_cv_.notify_all();
+
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+
+    // Whatever the flush thread didn't get to (or everything, if it never ran)
+    flush();
+}
+
+uint64_t OrderRepository::append(JournalRecordType type, const google::protobuf::MessageLite& message,
+                                 int64_t timestamp_ns) {
+    size_t length = message.ByteSizeLong();
+    size_t record_bytes = align8(sizeof(JournalRecordHeader) + length);
+    if (active_->write_offset + record_bytes > active_->size && !roll(record_bytes)) {
+        append_failures_.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    // Payload first, header last: a record is only complete once its header is
+    uint8_t* at = active_->base + active_->write_offset;
+    uint8_t* payload = at + sizeof(JournalRecordHeader);
+    message.SerializeWithCachedSizesToArray(payload);
+
+    JournalRecordHeader header;
+    header.length = static_cast<uint32_t>(length);
+    header.crc = 0;
+    header.sequence = next_sequence_;
+    header.timestamp_ns = timestamp_ns;
+    header.type = static_cast<uint32_t>(type);
+    header.reserved = 0;
+    header.crc = crc32c(crc32c(0, &header, sizeof(header)), payload, length);
+    std::memcpy(at, &header, sizeof(header));
+
+    // Padding is already zero: segments start zero-filled and are never rewritten
+    active_->write_offset += record_bytes;
+    published_offset_.store(active_->write_offset, std::memory_order_release);
+    published_sequence_.store(next_sequence_, std::memory_order_release);
+    return next_sequence_++;
+}
+
+bool OrderRepository::roll(size_t record_bytes) {
+    if (record_bytes > options_.segment_bytes - sizeof(SegmentHeader)) {
+        return false;  // Would never fit
+    }
+
+    std::unique_ptr<Segment> next;
+    uint32_t index = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        next = std::move(spare_);
+        if (!next) {
+            index = next_index_++;
+        }
+    }
+    if (!next) {
+        // Slow path: the flush thread hasn't prepared one (or isn't running)
+        next = create_segment(index);
+        if (!next) {
+            return false;
+        }
+    }
+
+    reinterpret_cast<SegmentHeader*>(next->base)->first_sequence = next_sequence_;
+    next->write_offset = sizeof(SegmentHeader);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retired_.push_back(std::move(active_));
+        active_ = std::move(next);
+        published_offset_.store(active_->write_offset, std::memory_order_release);
+        flush_requested_ = true;
+    }
+    flush_cv_.notify_one();
+    return true;
+}
+
+bool OrderRepository::wait_durable(uint64_t sequence, std::chrono::milliseconds timeout) {
+    if (durable_sequence() >= sequence) {
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    flush_requested_ = true;
+    flush_cv_.notify_one();
+    durable_cv_.wait_for(lock, timeout, [this, sequence] {
+        return durable_sequence() >= sequence || !running_;
+    });
+    return durable_sequence() >= sequence;
+}
+
+void OrderRepository::run() {
+    monitor::MonitoredThread monitor("Exchange_Journal");
+    auto interval = std::chrono::milliseconds(options_.flush_interval_ms);
+
+    while (running_) {
+        monitor.update_state(monitor::ThreadState::IDLE);
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            flush_cv_.wait_for(lock, interval, [this] { return flush_requested_ || !running_; });
+            flush_requested_ = false;
+        }
+
+        monitor.update_state(monitor::ThreadState::RUNNING);
+        flush();
+
+        // Have the next segment ready before the writer needs it
+        uint32_t index = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!spare_) {
+                index = next_index_++;
+            }
+        }
+        if (index != 0) {
+            auto spare = create_segment(index);
+            std::lock_guard<std::mutex> lock(mutex_);
+            spare_ = std::move(spare);
+        }
+        monitor.increment_tasks();
+    }
+}
+
+void OrderRepository::flush() {
+    std::vector<std::unique_ptr<Segment>> retired;
+    Segment* active;
+    size_t end;
+    uint64_t sequence;
+    {
+        // Sequence before offset: the offset read is at or past that record's end
+        std::lock_guard<std::mutex> lock(mutex_);
+        retired.swap(retired_);
+        sequence = published_sequence_.load(std::memory_order_acquire);
+        end = published_offset_.load(std::memory_order_acquire);
+        active = active_.get();
+    }
+
+    // Only this thread closes segments, so `active` stays mapped meanwhile.
+    // Records are durable only once everything before them is: stop at the
+    // first failure and keep unsynced segments mapped for the next attempt
+    bool ok = true;
+    std::vector<std::unique_ptr<Segment>> unsynced;
+    for (auto& segment : retired) {
+        if (ok && flush_range(*segment, segment->write_offset)) {
+            close_segment(*segment);
+        } else {
+            ok = false;
+            unsynced.push_back(std::move(segment));
+        }
+    }
+    ok = ok && flush_range(*active, end);
+
+    if (!unsynced.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retired_.insert(retired_.begin(), std::make_move_iterator(unsynced.begin()),
+                        std::make_move_iterator(unsynced.end()));
+    }
+
+    if (ok && sequence > durable_sequence()) {
+        durable_sequence_.store(sequence, std::memory_order_release);
+        { std::lock_guard<std::mutex> lock(mutex_); }  // Waiters are either parked or see the new value
+        durable_cv_.notify_all();
+    }
+}
+
+bool OrderRepository::flush_range(Segment& segment, size_t end) {
+    if (end <= segment.flushed_offset) {
+        return true;
+    }
+
+    if (options_.durability != DurabilityMode::NONE) {
+        // msync wants a page-aligned start
+        size_t start = segment.flushed_offset & ~(page_size() - 1);
+        if (::msync(segment.base + start, end - start, MS_SYNC) != 0) {
+            // Retried every flush; only the first failure in a row is reported
+            if (!flush_failing_) {
+                std::cerr << "[JOURNAL] msync failed: " << std::strerror(errno) << "\n";
+                flush_failing_ = true;
+            }
+            return false;
+        }
+    }
+    flush_failing_ = false;
+    segment.flushed_offset = end;
+    return true;
+}
+
+std::unique_ptr<OrderRepository::Segment> OrderRepository::create_segment(uint32_t index) const {
+    std::string path = segment_path(options_.directory, index);
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "[JOURNAL] Cannot create " << path << ": " << std::strerror(errno) << "\n";
+        return nullptr;
+    }
+
+    // Reserve the blocks now so appends never hit a full disk halfway through a segment
+    size_t size = options_.segment_bytes;
+    if (::posix_fallocate(fd, 0, static_cast<off_t>(size)) != 0 &&
+        ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        std::cerr << "[JOURNAL] Cannot size " << path << ": " << std::strerror(errno) << "\n";
+        ::close(fd);
+        ::unlink(path.c_str());
+        return nullptr;
+    }
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;  // Fault the pages in here, not on the writer
+#endif
+    void* base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "[JOURNAL] Cannot map " << path << ": " << std::strerror(errno) << "\n";
+        ::close(fd);
+        ::unlink(path.c_str());
+        return nullptr;
+    }
+
+    auto segment = std::make_unique<Segment>();
+    segment->index = index;
+    segment->fd = fd;
+    segment->base = static_cast<uint8_t*>(base);
+    segment->size = size;
+
+    auto* header = reinterpret_cast<SegmentHeader*>(segment->base);
+    std::memcpy(header->magic, kSegmentMagic, sizeof(kSegmentMagic));
+    header->version = kSegmentVersion;
+    header->header_bytes = sizeof(SegmentHeader);
+    header->first_sequence = 0;
+    header->segment_bytes = size;
+
+    if (options_.durability != DurabilityMode::NONE) {
+        // Make the new directory entry itself durable
+        int dir_fd = ::open(options_.directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dir_fd >= 0) {
+            ::fsync(dir_fd);
+            ::close(dir_fd);
+        }
+    }
+    return segment;
+}
+
+void OrderRepository::close_segment(Segment& segment) const {
+    if (segment.base) {
+        ::munmap(segment.base, segment.size);
+        segment.base = nullptr;
+    }
+    if (segment.fd >= 0) {
+        ::close(segment.fd);
+        segment.fd = -1;
+    }
+}
+
+// ============================================================================
+// JournalReader
+// ============================================================================
+
+JournalReader::JournalReader(const std::string& directory, uint64_t after_sequence)
+    : segment_(0)
+    , offset_(sizeof(SegmentHeader))
+    , after_sequence_(after_sequence)
+    , last_sequence_(0)
+    , torn_records_(0)
+    , last_index_(0)
+{
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        uint32_t index = segment_index(entry.path().filename().string());
+        if (index == 0 || !entry.is_regular_file()) {
+            continue;
+        }
+
+        MappedSegment segment;
+        segment.index = index;
+        segment.path = entry.path().string();
+        last_index_ = std::max(last_index_, index);
+
+        // Header only for now; segments are mapped when reached
+        int fd = ::open(segment.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        SegmentHeader header;
+        bool valid = ::pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                     std::memcmp(header.magic, kSegmentMagic, sizeof(kSegmentMagic)) == 0 &&
+                     header.version == kSegmentVersion;
+        ::close(fd);
+
+        // Segments the writer never started are empty
+        if (valid && header.first_sequence != 0) {
+            segment.first_sequence = header.first_sequence;
+            segments_.push_back(std::move(segment));
+        }
+    }
+
+    std::sort(segments_.begin(), segments_.end(),
+              [](const MappedSegment& a, const MappedSegment& b) { return a.index < b.index; });
+
+    // Start at the last segment that can still hold records after after_sequence
+    while (segment_ + 1 < segments_.size() && segments_[segment_ + 1].first_sequence - 1 <= after_sequence_) {
+        ++segment_;
+    }
+}
+
+JournalReader::~JournalReader() {
+    for (auto& segment : segments_) {
+        if (segment.base) {
+            ::munmap(const_cast<uint8_t*>(segment.base), segment.size);
+        }
+    }
+}
+
+JournalReader::MappedSegment* JournalReader::current() {
+    while (segment_ < segments_.size()) {
+        MappedSegment& segment = segments_[segment_];
+        if (segment.base) {
+            return &segment;
+        }
+
+        int fd = ::open(segment.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            off_t size = ::lseek(fd, 0, SEEK_END);
+            if (size > static_cast<off_t>(sizeof(SegmentHeader))) {
+                void* base = ::mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_SHARED, fd, 0);
+                if (base != MAP_FAILED) {
+                    segment.base = static_cast<const uint8_t*>(base);
+                    segment.size = static_cast<size_t>(size);
+                }
+            }
+            ::close(fd);  // The mapping keeps the file
+        }
+
+        if (segment.base) {
+            offset_ = sizeof(SegmentHeader);
+            last_sequence_ = std::max(last_sequence_, segment.first_sequence - 1);
+            return &segment;
+        }
+        ++segment_;
+    }
+    return nullptr;
+}
+
+bool JournalReader::next(JournalRecord& record) {
+    while (MappedSegment* segment = current()) {
+        size_t available = segment->size - offset_;
+        JournalRecordHeader header;
+        if (available < sizeof(header)) {
+            ++segment_;
+            continue;
+        }
+        std::memcpy(&header, segment->base + offset_, sizeof(header));
+
+        if (header.sequence == 0) {
+            ++segment_;  // Unused rest of the segment
+            continue;
+        }
+        if (!record_valid(header, segment->base + offset_, available)) {
+            ++torn_records_;  // Torn or corrupt: nothing after it in this segment is trusted
+            ++segment_;
+            continue;
+        }
+
+        const uint8_t* payload = segment->base + offset_ + sizeof(header);
+        offset_ += align8(sizeof(header) + header.length);
+        last_sequence_ = header.sequence;
+        if (header.sequence <= after_sequence_) {
+            continue;
+        }
+
+        record.sequence = header.sequence;
+        record.timestamp_ns = header.timestamp_ns;
+        record.type = static_cast<JournalRecordType>(header.type);
+        record.payload = std::string_view(reinterpret_cast<const char*>(payload), header.length);
+        return true;
+    }
+    return false;
+}
+
+} // namespace marketsim::exchange::repository
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <google/protobuf/message_lite.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace marketsim::exchange::repository {
+
+/**
+ * @brief When journal records are forced to stable storage
+ */
+enum class DurabilityMode : uint8_t {
+    NONE,    // Left to the OS page cache: survives a process crash, not a power loss
+    ASYNC,   // msync'd every flush interval; acks don't wait for it
+    SYNC     // Acks wait until their record is msync'd (group commit)
+};
+
+/**
+ * @brief What a journal record's payload is
+ */
+enum class JournalRecordType : uint32_t {
+    ORDER = 1,   // Serialized Order
+    BATCH = 2    // Serialized OrderBatch
+};
+
+/**
+ * @brief On-disk record header, followed by `length` payload bytes
+ *
+ * Records are padded to 8 bytes. The CRC-32C covers the header (with crc
+ * zeroed) and the payload, so a torn write at the tail is detected on read.
+ * A zero sequence marks the unused, zero-filled end of a segment.
+ */
+struct JournalRecordHeader {
+    uint32_t length;         // Payload bytes
+    uint32_t crc;
+    uint64_t sequence;       // From 1, contiguous across segments
+    int64_t timestamp_ns;    // When the exchange received it (since epoch)
+    uint32_t type;           // JournalRecordType
+    uint32_t reserved;
+};
+
+static_assert(sizeof(JournalRecordHeader) == 32, "journal header layout is part of the file format");
+
+/**
+ * @brief One record as read back (payload points into the mapped segment)
+ */
+struct JournalRecord {
+    uint64_t sequence = 0;
+    int64_t timestamp_ns = 0;
+    JournalRecordType type = JournalRecordType::ORDER;
+    std::string_view payload;
+};
+
+/**
+ * @brief Journal location, segment size and durability
+ */
+struct JournalOptions {
+    std::string directory;
+    size_t segment_bytes = 64 * 1024 * 1024;
+    DurabilityMode durability = DurabilityMode::ASYNC;
+    int flush_interval_ms = 5;   // ASYNC flush period (also the SYNC idle wakeup)
+};
+
+/**
+ * @brief Append-only write-ahead journal of inbound orders
+ *
+ * Records go straight into a memory-mapped, pre-allocated segment file
+ * (`orders-<index>.wal`): an append is a protobuf serialize into the mapping,
+ * a CRC and two atomic stores - no syscall, no lock, no allocation. A
+ * background thread does everything slow: it msyncs what was appended since
+ * its last pass (one msync covers every record in between - group commit),
+ * prepares the next segment ahead of time so rolling over is a pointer
+ * swap, and unmaps full segments once they are flushed.
+ *
+ * Single writer. durable_sequence() and wait_durable() may be used from any
+ * thread. Opening a directory that already holds a journal continues its
+ * sequence in a fresh segment.
+ */
+class OrderRepository {
+public:
+    /**
+     * @brief Open (or create) the journal in options.directory
+     * @throws std::runtime_error if the directory or first segment can't be set up
+     */
+    explicit OrderRepository(const JournalOptions& options);
+
+    ~OrderRepository();
+
+    OrderRepository(const OrderRepository&) = delete;
+    OrderRepository& operator=(const OrderRepository&) = delete;
+
+    /**
+     * @brief Start the background flush thread
+     */
+    void start();
+
+    /**
+     * @brief Flush everything appended so far and stop the background thread
+     */
+    void stop();
+
+    /**
+     * @brief Append one record (writer thread only)
+     * @return Sequence number of the record, 0 if it couldn't be written
+     */
+    uint64_t append(JournalRecordType type, const google::protobuf::MessageLite& message,
+                    int64_t timestamp_ns);
+
+    /**
+     * @brief Wait until every record up to sequence is durable (per the mode)
+     * @return false on timeout or if the journal stopped first
+     */
+    bool wait_durable(uint64_t sequence, std::chrono::milliseconds timeout);
+
+    // Newest sequence appended / flushed as far as the durability mode goes
+    uint64_t last_sequence() const { return published_sequence_.load(std::memory_order_acquire); }
+    uint64_t durable_sequence() const { return durable_sequence_.load(std::memory_order_acquire); }
+
+    DurabilityMode durability() const { return options_.durability; }
+    bool is_running() const { return running_; }
+    const std::string& directory() const { return options_.directory; }
+
+    // Records dropped because they couldn't be written (e.g. larger than a segment)
+    uint64_t append_failures() const { return append_failures_.load(std::memory_order_relaxed); }
+
+private:
+    struct Segment {
+        uint32_t index = 0;
+        int fd = -1;
+        uint8_t* base = nullptr;
+        size_t size = 0;
+        size_t write_offset = 0;     // Writer thread only
+        size_t flushed_offset = 0;   // Flush thread only
+    };
+
+    // Create, size and map segment `index` (prefaulted, so appends don't page fault)
+    std::unique_ptr<Segment> create_segment(uint32_t index) const;
+    void close_segment(Segment& segment) const;
+
+    // Take the prepared segment (or make one) and start it at next_sequence_
+    bool roll(size_t record_bytes);
+
+    void run();
+    // Advances durable_sequence_ only if every range up to it synced
+    void flush();
+    bool flush_range(Segment& segment, size_t end);
+
+    JournalOptions options_;
+
+    // Writer side
+    std::unique_ptr<Segment> active_;
+    uint64_t next_sequence_;
+    std::atomic<size_t> published_offset_;      // End of the last complete record in active_
+    std::atomic<uint64_t> published_sequence_;
+    std::atomic<uint64_t> append_failures_;
+
+    // Shared with the flush thread (roll, flush requests, durable waits)
+    std::mutex mutex_;
+    std::condition_variable flush_cv_;
+    std::condition_variable durable_cv_;
+    std::unique_ptr<Segment> spare_;                 // Next segment, ready to go
+    std::vector<std::unique_ptr<Segment>> retired_;  // Full segments awaiting a final flush
+    uint32_t next_index_;
+    bool flush_requested_;
+
+    bool flush_failing_;    // Flush thread only: last msync failed
+
+    std::atomic<uint64_t> durable_sequence_;
+
+    // Threading
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<bool> running_;
+};
+
+/**
+ * @brief Sequential reader over a journal directory
+ *
+ * Walks the segments in order and stops at the first torn or corrupt record
+ * of each one (the tail of a crashed run), so only complete, CRC-checked
+ * records are returned. Payloads point into read-only mappings that stay
+ * valid until the reader is destroyed.
+ */
+class JournalReader {
+public:
+    /**
+     * @brief Open every segment in directory (an empty or missing directory reads as empty)
+     * @param after_sequence Skip records up to and including this sequence
+     */
+    explicit JournalReader(const std::string& directory, uint64_t after_sequence = 0);
+
+    ~JournalReader();
+
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    /**
+     * @brief Read the next record
+     * @return false once the journal is exhausted
+     */
+    bool next(JournalRecord& record);
+
+    // Records that failed their CRC or were cut short (at most one per segment)
+    size_t torn_records() const { return torn_records_; }
+
+    // Newest sequence read or skipped so far
+    uint64_t last_sequence() const { return last_sequence_; }
+
+    // Index of the newest segment file in the directory (0 if none)
+    uint32_t last_segment_index() const { return last_index_; }
+
+private:
+    struct MappedSegment {
+        uint32_t index = 0;
+        std::string path;
+        const uint8_t* base = nullptr;
+        size_t size = 0;
+        uint64_t first_sequence = 0;
+    };
+
+    MappedSegment* current();
+
+    std::vector<MappedSegment> segments_;
+    size_t segment_;    // Position in segments_
+    size_t offset_;     // Position in the current segment
+    uint64_t after_sequence_;
+    uint64_t last_sequence_;
+    size_t torn_records_;
+    uint32_t last_index_;
+};
+
+/**
+ * @brief CRC-32C (Castagnoli) of data, continuing from crc
+ */
+uint32_t crc32c(uint32_t crc, const void* data, size_t size);
+
+} // namespace marketsim::exchange::repository
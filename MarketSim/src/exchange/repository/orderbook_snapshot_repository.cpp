@@ -0,0 +1,461 @@
+#include "orderbook_snapshot_repository.h"
+#include "order_repository.h"
+#include "monitor/monitor_helpers.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace marketsim::exchange::repository {
+
+namespace {
+
+// File header; the CRC-32C covers the body (every section after it)
+struct SnapshotFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t book_count;
+    uint64_t journal_sequence;   // Minimum over the sections and the shards' positions
+    int64_t created_ns;
+    uint64_t body_bytes;
+    uint32_t crc;
+    uint32_t reserved;
+};
+
+// One book: this header, the symbol, then order_count orders
+struct SectionHeader {
+    uint32_t section_bytes;      // Including this header
+    uint32_t order_count;
+    uint64_t journal_sequence;
+    uint64_t orders_received;
+    uint64_t trade_count;
+    double total_volume;
+    uint64_t last_trade_sequence;
+    uint32_t symbol_length;
+    uint32_t reserved;
+};
+
+// One resting order: this record, then the order id and client id
+struct OrderRecord {
+    double price;
+    double quantity;
+    double filled_quantity;
+    int64_t timestamp;
+    uint32_t order_id_length;
+    uint16_t client_id_length;
+    uint8_t is_buy;
+    uint8_t reserved;
+};
+
+static_assert(sizeof(SnapshotFileHeader) == 48, "snapshot header layout is part of the file format");
+static_assert(sizeof(SectionHeader) == 56, "section header layout is part of the file format");
+static_assert(sizeof(OrderRecord) == 40, "order record layout is part of the file format");
+
+constexpr char kSnapshotMagic[8] = { 'M', 'S', 'S', 'N', 'A', 'P', '0', '1' };
+constexpr uint32_t kSnapshotVersion = 1;
+constexpr const char* kSnapshotPrefix = "books-";
+constexpr const char* kSnapshotSuffix = ".snap";
+
+template<typename T>
+void append_pod(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Bounds-checked reads over a loaded file
+struct Cursor {
+    const char* at;
+    const char* end;
+
+    template<typename T>
+    bool read(T& value) {
+        if (static_cast<size_t>(end - at) < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, at, sizeof(T));
+        at += sizeof(T);
+        return true;
+    }
+
+    bool read(std::string& value, size_t length) {
+        if (static_cast<size_t>(end - at) < length) {
+            return false;
+        }
+        value.assign(at, length);
+        at += length;
+        return true;
+    }
+};
+
+std::string snapshot_path(const std::string& directory, uint32_t index) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%s%08u%s", kSnapshotPrefix, index, kSnapshotSuffix);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+// Index from "books-<index>.snap", or 0 if the name doesn't match
+uint32_t snapshot_index(const std::string& name) {
+    std::string_view view(name);
+    std::string_view prefix(kSnapshotPrefix);
+    std::string_view suffix(kSnapshotSuffix);
+    if (view.size() <= prefix.size() + suffix.size() ||
+        view.substr(0, prefix.size()) != prefix ||
+        view.substr(view.size() - suffix.size()) != suffix) {
+        return 0;
+    }
+
+    uint32_t index = 0;
+    for (char c : view.substr(prefix.size(), view.size() - prefix.size() - suffix.size())) {
+        if (c < '0' || c > '9') {
+            return 0;
+        }
+        index = index * 10 + static_cast<uint32_t>(c - '0');
+    }
+    return index;
+}
+
+// Snapshot files in directory, newest first
+std::vector<std::pair<uint32_t, std::string>> list_snapshots(const std::string& directory) {
+    std::vector<std::pair<uint32_t, std::string>> files;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        uint32_t index = snapshot_index(entry.path().filename().string());
+        if (index != 0 && entry.is_regular_file()) {
+            files.emplace_back(index, entry.path().string());
+        }
+    }
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    return files;
+}
+
+bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool decode_section(Cursor& cursor, BookImage& image) {
+    const char* start = cursor.at;
+    SectionHeader header;
+    if (!cursor.read(header) || header.section_bytes < sizeof(header) ||
+        static_cast<size_t>(cursor.end - start) < header.section_bytes ||
+        !cursor.read(image.symbol, header.symbol_length)) {
+        return false;
+    }
+    image.journal_sequence = header.journal_sequence;
+    image.orders_received = header.orders_received;
+    image.trade_count = header.trade_count;
+    image.total_volume = header.total_volume;
+    image.last_trade_sequence = header.last_trade_sequence;
+
+    image.orders.resize(header.order_count);
+    for (auto& order : image.orders) {
+        OrderRecord record;
+        if (!cursor.read(record) ||
+            !cursor.read(order.order_id, record.order_id_length) ||
+            !cursor.read(order.client_id, record.client_id_length)) {
+            return false;
+        }
+        order.price = record.price;
+        order.quantity = record.quantity;
+        order.filled_quantity = record.filled_quantity;
+        order.timestamp = record.timestamp;
+        order.is_buy = record.is_buy != 0;
+    }
+    return cursor.at == start + header.section_bytes;
+}
+
+bool read_snapshot(const std::string& path, LoadedSnapshot& snapshot) {
+    std::ifstream in(path, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    Cursor cursor{ data.data(), data.data() + data.size() };
+    SnapshotFileHeader header;
+    if (!cursor.read(header) ||
+        std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+        header.version != kSnapshotVersion ||
+        header.body_bytes != static_cast<uint64_t>(cursor.end - cursor.at) ||
+        crc32c(0, cursor.at, header.body_bytes) != header.crc) {
+        return false;
+    }
+
+    snapshot.path = path;
+    snapshot.journal_sequence = header.journal_sequence;
+    snapshot.created_ns = header.created_ns;
+    snapshot.books.resize(header.book_count);
+    for (auto& image : snapshot.books) {
+        if (!decode_section(cursor, image)) {
+            return false;
+        }
+    }
+    return cursor.at == cursor.end;
+}
+
+}
+
+// ============================================================================
+// OrderBookSnapshotRepository
+// ============================================================================
+
+OrderBookSnapshotRepository::OrderBookSnapshotRepository(const SnapshotOptions& options, size_t shard_count)
+    : options_(options)
+    , shard_count_(shard_count > 0 ? shard_count : 1)
+    , next_index_(1)
+    , requested_round_(0)
+    , collecting_(false)
+    , submitted_(0)
+    , round_floor_(UINT64_MAX)
+    , snapshots_written_(0)
+    , running_(false)
+{
+    if (options_.interval_ms <= 0) {
+        options_.interval_ms = 1;
+    }
+    options_.retain = std::max<size_t>(options_.retain, 1);
+
+    std::error_code ec;
+    std::filesystem::create_directories(options_.directory, ec);
+    if (ec) {
+        throw std::runtime_error("Cannot create snapshot directory " + options_.directory + ": " + ec.message());
+    }
+
+    // Number after whatever an earlier run left
+    auto existing = list_snapshots(options_.directory);
+    if (!existing.empty()) {
+        next_index_ = existing.front().first + 1;
+    }
+}
+
+OrderBookSnapshotRepository::~OrderBookSnapshotRepository() {
+    stop();
+}
+
+void OrderBookSnapshotRepository::start() {
+    if (running_) {
+        return;
+    }
+
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&OrderBookSnapshotRepository::run, this);
+}
+
+void OrderBookSnapshotRepository::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+}
+
+void OrderBookSnapshotRepository::submit(uint64_t round, uint64_t applied_sequence,
+                                         std::vector<std::string>&& sections) {
+    bool complete;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!collecting_ || round != requested_round_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        for (auto& section : sections) {
+            sections_.push_back(std::move(section));
+        }
+        round_floor_ = std::min(round_floor_, applied_sequence);
+        ++submitted_;
+        complete = round_complete();
+    }
+    if (complete) {
+        cv_.notify_one();
+    }
+}
+
+void OrderBookSnapshotRepository::run() {
+    monitor::MonitoredThread monitor("Exchange_Snapshot");
+    auto interval = std::chrono::milliseconds(options_.interval_ms);
+    auto next_round = std::chrono::steady_clock::now() + interval;
+
+    while (running_) {
+        monitor.update_state(monitor::ThreadState::IDLE);
+        std::vector<std::string> sections;
+        uint64_t floor = UINT64_MAX;
+        bool complete = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_until(lock, next_round, [this] { return !running_ || round_complete(); });
+            if (!running_) {
+                break;
+            }
+            if (round_complete()) {
+                sections.swap(sections_);
+                floor = round_floor_;
+                collecting_ = false;
+                complete = true;
+            } else {
+                // Open the next round, unless a shard is still busy with this one
+                next_round = std::chrono::steady_clock::now() + interval;
+                if (!collecting_) {
+                    collecting_ = true;
+                    submitted_ = 0;
+                    round_floor_ = UINT64_MAX;
+                    requested_round_.fetch_add(1, std::memory_order_release);
+                }
+            }
+        }
+
+        // No symbols yet: nothing worth a file
+        if (complete && !sections.empty()) {
+            monitor.update_state(monitor::ThreadState::RUNNING);
+            write(sections, floor);
+            monitor.increment_tasks();
+        }
+    }
+}
+
+bool OrderBookSnapshotRepository::write(const std::vector<std::string>& sections, uint64_t journal_floor) {
+    SnapshotFileHeader header;
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kSnapshotVersion;
+    header.book_count = static_cast<uint32_t>(sections.size());
+    header.journal_sequence = journal_floor;
+    header.created_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    header.body_bytes = 0;
+    header.crc = 0;
+    header.reserved = 0;
+    for (const auto& section : sections) {
+        SectionHeader section_header;
+        std::memcpy(&section_header, section.data(), sizeof(section_header));
+        header.journal_sequence = std::min(header.journal_sequence, section_header.journal_sequence);
+        header.body_bytes += section.size();
+        header.crc = crc32c(header.crc, section.data(), section.size());
+    }
+    if (sections.empty()) {
+        header.journal_sequence = 0;
+    }
+
+    // Temp name first, so a crash mid-write never leaves a half file under a snapshot name
+    std::string path = snapshot_path(options_.directory, next_index_);
+    std::string temp = path + ".tmp";
+    int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "[SNAPSHOT] Cannot create " << temp << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    bool ok = write_all(fd, reinterpret_cast<const char*>(&header), sizeof(header));
+    for (size_t i = 0; ok && i < sections.size(); ++i) {
+        ok = write_all(fd, sections[i].data(), sections[i].size());
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ::close(fd);
+    if (!ok || ::rename(temp.c_str(), path.c_str()) != 0) {
+        std::cerr << "[SNAPSHOT] Cannot write " << path << ": " << std::strerror(errno) << "\n";
+        ::unlink(temp.c_str());
+        return false;
+    }
+
+    // Make the rename itself durable
+    int dir_fd = ::open(options_.directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd >= 0) {
+        ::fsync(dir_fd);
+        ::close(dir_fd);
+    }
+
+    ++next_index_;
+    snapshots_written_.fetch_add(1, std::memory_order_relaxed);
+    prune();
+    return true;
+}
+
+void OrderBookSnapshotRepository::prune() {
+    auto files = list_snapshots(options_.directory);
+    for (size_t i = options_.retain; i < files.size(); ++i) {
+        ::unlink(files[i].second.c_str());
+    }
+}
+
+// ============================================================================
+// Encoding / recovery
+// ============================================================================
+
+void encode_book(const operations::MatchingEngine& engine, uint64_t journal_sequence,
+                 uint64_t orders_received, std::string& out) {
+    const auto& book = engine.get_order_book();
+    size_t start = out.size();
+    size_t order_count = book.total_buy_orders() + book.total_sell_orders();
+    out.reserve(start + sizeof(SectionHeader) + book.get_symbol().size() +
+                order_count * (sizeof(OrderRecord) + 16));
+
+    SectionHeader header;
+    header.section_bytes = 0;   // Patched below
+    header.order_count = static_cast<uint32_t>(order_count);
+    header.journal_sequence = journal_sequence;
+    header.orders_received = orders_received;
+    header.trade_count = engine.total_trades();
+    header.total_volume = engine.total_volume();
+    header.last_trade_sequence = engine.last_trade_sequence();
+    header.symbol_length = static_cast<uint32_t>(book.get_symbol().size());
+    header.reserved = 0;
+    append_pod(out, header);
+    out.append(book.get_symbol());
+
+    engine.for_each_resting_order([&out](const operations::OrderEntry& entry,
+                                         const std::string& order_id, const std::string& client_id) {
+        OrderRecord record;
+        record.price = entry.price;
+        record.quantity = entry.quantity;
+        record.filled_quantity = entry.filled_quantity;
+        record.timestamp = entry.timestamp;
+        record.order_id_length = static_cast<uint32_t>(order_id.size());
+        record.client_id_length = static_cast<uint16_t>(client_id.size());
+        record.is_buy = entry.is_buy ? 1 : 0;
+        record.reserved = 0;
+        append_pod(out, record);
+        out.append(order_id);
+        out.append(client_id);
+    });
+
+    auto section_bytes = static_cast<uint32_t>(out.size() - start);
+    std::memcpy(out.data() + start, &section_bytes, sizeof(section_bytes));
+}
+
+bool load_latest_snapshot(const std::string& directory, LoadedSnapshot& snapshot) {
+    for (const auto& [index, path] : list_snapshots(directory)) {
+        LoadedSnapshot candidate;
+        if (read_snapshot(path, candidate)) {
+            snapshot = std::move(candidate);
+            return true;
+        }
+        std::cerr << "[SNAPSHOT] Skipping damaged snapshot " << path << "\n";
+    }
+    return false;
+}
+
+void restore_book(const BookImage& image, operations::MatchingEngine& engine) {
+    for (const auto& order : image.orders) {
+        engine.restore_order(order.order_id, order.client_id, order.price, order.quantity,
+                             order.filled_quantity, order.timestamp, order.is_buy);
+    }
+    engine.finish_restore(image.trade_count, image.total_volume, image.last_trade_sequence);
+}
+
+} // namespace marketsim::exchange::repository
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "exchange/operations/matching_engine.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace marketsim::exchange::repository {
+
+/**
+ * @brief Snapshot location, cadence and retention
+ */
+struct SnapshotOptions {
+    std::string directory;
+    int interval_ms = 10000;   // Time between snapshot rounds
+    size_t retain = 2;         // Snapshot files kept (older ones are deleted)
+};
+
+/**
+ * @brief One resting order as stored in a snapshot
+ */
+struct SnapshotOrder {
+    std::string order_id;
+    std::string client_id;
+    double price = 0;
+    double quantity = 0;
+    double filled_quantity = 0;
+    int64_t timestamp = 0;
+    bool is_buy = false;
+};
+
+/**
+ * @brief One symbol's engine state as read back from a snapshot
+ */
+struct BookImage {
+    std::string symbol;
+    uint64_t journal_sequence = 0;      // Every journal record for this symbol up to here is included
+    uint64_t orders_received = 0;
+    uint64_t trade_count = 0;
+    double total_volume = 0;
+    uint64_t last_trade_sequence = 0;
+    std::vector<SnapshotOrder> orders;  // Bids then asks, best level first, FIFO within a level
+};
+
+/**
+ * @brief The newest intact snapshot in a directory
+ */
+struct LoadedSnapshot {
+    std::string path;
+    uint64_t journal_sequence = 0;   // Recovery floor (oldest book or shard position): replay the journal after it
+    int64_t created_ns = 0;
+    std::vector<BookImage> books;
+};
+
+/**
+ * @brief Periodic binary snapshots of every matching engine's book
+ *
+ * A background thread opens a snapshot round every interval. Matching shards
+ * poll requested_round() between batches and, when it moves, copy their
+ * books into flat binary sections with encode_book() - one symbol per batch
+ * while busy, the rest at once when idle - so matching is never held up for
+ * more than one book. Once every shard has submitted, the thread writes the
+ * sections as one CRC-checked file (`books-<index>.snap`, written to a temp
+ * name, fsync'd and renamed) and prunes old ones.
+ *
+ * Each section records the newest journal sequence its shard had matched when
+ * the book was copied, and every shard - including one with no books yet -
+ * reports where it stood when it submitted: a symbol it creates later comes
+ * from a record after that. The file's journal sequence is the minimum of
+ * all of these, so recovery is: load_latest_snapshot(), restore_book() each
+ * image, then replay the journal after LoadedSnapshot::journal_sequence,
+ * skipping records a book already contains.
+ */
+class OrderBookSnapshotRepository {
+public:
+    /**
+     * @brief Prepare the snapshot directory
+     * @param shard_count Shards that submit to each round
+     * @throws std::runtime_error if the directory can't be created
+     */
+    OrderBookSnapshotRepository(const SnapshotOptions& options, size_t shard_count);
+
+    ~OrderBookSnapshotRepository();
+
+    OrderBookSnapshotRepository(const OrderBookSnapshotRepository&) = delete;
+    OrderBookSnapshotRepository& operator=(const OrderBookSnapshotRepository&) = delete;
+
+    /**
+     * @brief Start the background round/writer thread
+     */
+    void start();
+
+    /**
+     * @brief Stop the background thread (an unfinished round is dropped)
+     */
+    void stop();
+
+    /**
+     * @brief Round the shards should capture (0 = none yet); cheap enough to poll per batch
+     */
+    uint64_t requested_round() const { return requested_round_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Hand over one shard's encoded books for `round` (stale rounds are ignored)
+     * @param applied_sequence Newest journal record the shard had matched (also with no books)
+     */
+    void submit(uint64_t round, uint64_t applied_sequence, std::vector<std::string>&& sections);
+
+    /**
+     * @brief Write sections as the next snapshot file now
+     * @param journal_floor Recovery floor beyond the sections' own (e.g. shards without books)
+     * @return false if nothing could be written
+     */
+    bool write(const std::vector<std::string>& sections, uint64_t journal_floor = UINT64_MAX);
+
+    uint64_t snapshots_written() const { return snapshots_written_.load(std::memory_order_relaxed); }
+    const std::string& directory() const { return options_.directory; }
+
+private:
+    void run();
+    bool round_complete() const { return collecting_ && submitted_ == shard_count_; }
+
+    // Delete all but the newest options_.retain snapshot files
+    void prune();
+
+    SnapshotOptions options_;
+    size_t shard_count_;
+    uint32_t next_index_;   // Writer thread only
+
+    // Current round
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<uint64_t> requested_round_;
+    bool collecting_;
+    size_t submitted_;
+    uint64_t round_floor_;   // Minimum applied sequence over the shards that submitted
+    std::vector<std::string> sections_;
+
+    std::atomic<uint64_t> snapshots_written_;
+
+    // Threading
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<bool> running_;
+};
+
+/**
+ * @brief Append one engine's book and statistics to out as a snapshot section
+ * @param journal_sequence Newest journal record already applied to the engine
+ */
+void encode_book(const operations::MatchingEngine& engine, uint64_t journal_sequence,
+                 uint64_t orders_received, std::string& out);
+
+/**
+ * @brief Load the newest snapshot in directory that passes its checks
+ * @return false if there is none
+ */
+bool load_latest_snapshot(const std::string& directory, LoadedSnapshot& snapshot);
+
+/**
+ * @brief Rebuild an image's resting orders and statistics in an empty engine
+ */
+void restore_book(const BookImage& image, operations::MatchingEngine& engine);
+
+} // namespace marketsim::exchange::repository
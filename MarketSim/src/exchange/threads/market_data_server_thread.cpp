@@ -0,0 +1,285 @@
+#include "market_data_server_thread.h"
+#include "monitor/monitor_helpers.h"
+#include <algorithm>
+#include <iostream>
+
+namespace marketsim::exchange::threads {
+
+namespace {
+
+int64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+BookAction to_book_action(operations::LevelAction action) {
+    switch (action) {
+        case operations::LevelAction::ADD:    return BookAction::LEVEL_ADD;
+        case operations::LevelAction::CHANGE: return BookAction::LEVEL_CHANGE;
+        case operations::LevelAction::REMOVE: return BookAction::LEVEL_DELETE;
+    }
+    return BookAction::BOOK_ACTION_UNSPECIFIED;
+}
+
+// Apply one delta to a published side
+template<typename Side>
+void apply_delta(Side& side, const operations::LevelDelta& delta) {
+    if (delta.action == operations::LevelAction::REMOVE) {
+        side.erase(delta.price);
+    } else {
+        side[delta.price] = { delta.price, delta.quantity, delta.order_count };
+    }
+}
+
+template<typename Side>
+void add_levels(const Side& side, google::protobuf::RepeatedPtrField<OrderBookLevel>& out) {
+    for (const auto& [price, level] : side) {
+        auto* pb_level = out.Add();
+        pb_level->set_price(level.price);
+        pb_level->set_quantity(level.quantity);
+        pb_level->set_order_count(static_cast<int>(level.order_count));
+    }
+}
+
+}
+
+MarketDataServerThread::MarketDataServerThread(
+    io_handler::IOContext& io_context,
+    const config::ExchangeConfig& config,
+    MarketDataQueue& events,
+    models::PriceCache* price_cache)
+    : config_(config)
+    , events_(events)
+    , batch_(kBatchSize)
+    , price_cache_(price_cache)
+    , arena_block_(std::make_unique<char[]>(kArenaBlock))
+    , arena_(arena_block_.get(), kArenaBlock)
+    , updates_published_(0)
+    , snapshots_published_(0)
+    , quotes_published_(0)
+    , running_(false)
+{
+    publisher_ = std::make_unique<io_handler::ZmqPublisher>(io_context, "Exchange_MarketData", config.market_data_port);
+    publisher_->bind();
+    
+    if (!config.recovery_port.empty()) {
+        recovery_ = std::make_unique<io_handler::ZmqReplier>(io_context, "Exchange_MarketData_Recovery", config.recovery_port);
+        recovery_->bind();
+    }
+}
+
+MarketDataServerThread::~MarketDataServerThread() {
+    stop();
+}
+
+void MarketDataServerThread::start() {
+    if (running_) {
+        return;
+    }
+    
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&MarketDataServerThread::run, this);
+}
+
+void MarketDataServerThread::stop() {
+    running_ = false;
+    
+    // Wake up if blocked
+    events_.stop();
+    
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+}
+
+void MarketDataServerThread::run() {
+    monitor::MonitoredThread monitor("Exchange_MarketData");
+    
+    using Clock = std::chrono::steady_clock;
+    auto snapshot_interval = std::chrono::milliseconds(std::max(config_.snapshot_interval_ms, 1));
+    auto quote_interval = std::chrono::milliseconds(std::max(config_.quote_interval_ms, 0));
+    bool quote_on_change = price_cache_ && quote_interval.count() == 0;
+    bool quote_on_timer = price_cache_ && quote_interval.count() > 0;
+    auto next_snapshot = Clock::now() + snapshot_interval;
+    auto next_quote = Clock::now() + quote_interval;
+    
+    // Next deadline, moved forward without firing a run of catch-up ticks after a stall
+    auto advance = [](Clock::time_point& deadline, std::chrono::milliseconds interval) {
+        deadline += interval;
+        if (deadline < Clock::now()) {
+            deadline = Clock::now() + interval;
+        }
+    };
+    
+    while (running_) {
+        monitor.update_state(monitor::ThreadState::IDLE);
+        auto deadline = quote_on_timer ? std::min(next_snapshot, next_quote) : next_snapshot;
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+        wait = std::clamp(wait, std::chrono::milliseconds(0),
+                          recovery_ ? kRecoveryPoll : std::chrono::milliseconds(100));
+        size_t count = events_.pop_batch_for(batch_.data(), batch_.size(), wait);
+        
+        monitor.update_state(monitor::ThreadState::RUNNING);
+        for (size_t i = 0; i < count; ++i) {
+            publish_update(batch_[i]);
+            monitor.increment_tasks();
+            
+            // Back to its shard for reuse (if that pool is full, it is simply freed)
+            if (batch_[i].pool) {
+                batch_[i].pool->try_push(std::move(batch_[i]));
+            }
+        }
+        
+        // Every BBO change also changes the book, so it arrives with an event
+        if (quote_on_change && count > 0) {
+            publish_quotes();
+        }
+        if (quote_on_timer && Clock::now() >= next_quote) {
+            publish_quotes();
+            advance(next_quote, quote_interval);
+        }
+        
+        if (Clock::now() >= next_snapshot) {
+            publish_snapshots();
+            advance(next_snapshot, snapshot_interval);
+        }
+        
+        // After this round's updates, so a snapshot covers everything published
+        if (recovery_) {
+            serve_recovery();
+        }
+    }
+}
+
+void MarketDataServerThread::publish_update(MarketDataEvent& event) {
+    SymbolBook& book = books_[event.symbol];
+    if (book.topic.empty()) {
+        book.topic = market_data_topic(kBookTopicPrefix, event.symbol);
+    }
+    book.sequence = event.sequence;
+    if (event.reset) {
+        // Updates were dropped before this one: its levels are the whole book
+        book.bids.clear();
+        book.asks.clear();
+    }
+    
+    auto& message = *google::protobuf::Arena::CreateMessage<MarketDataMessage>(&arena_);
+    BookUpdate* update = message.mutable_book_update();
+    update->set_symbol(event.symbol);
+    update->set_sequence(event.sequence);
+    update->set_timestamp_us(event.timestamp_us);
+    
+    for (const auto& delta : event.levels) {
+        if (delta.is_buy) {
+            apply_delta(book.bids, delta);
+        } else {
+            apply_delta(book.asks, delta);
+        }
+        
+        auto* level = update->add_levels();
+        level->set_side(delta.is_buy ? OrderSide::BUY : OrderSide::SELL);
+        level->set_action(to_book_action(delta.action));
+        level->set_price(delta.price);
+        level->set_quantity(delta.quantity);
+        level->set_order_count(static_cast<int>(delta.order_count));
+    }
+    
+    // Public tape: no order ids
+    for (const auto& fill : event.trades) {
+        auto* trade = update->add_trades();
+        trade->set_trade_id(operations::MatchingEngine::format_trade_id(fill.trade_seq));
+        trade->set_symbol(event.symbol);
+        trade->set_price(static_cast<double>(fill.price_ticks) * event.tick_size);
+        trade->set_quantity(fill.quantity);
+        trade->set_timestamp(fill.timestamp);
+        trade->set_aggressor_side(fill.aggressor_is_buy ? OrderSide::BUY : OrderSide::SELL);
+        trade->set_sequence(fill.trade_seq);
+    }
+    
+    if (publisher_->publish_with_topic(book.topic, message)) {
+        updates_published_++;
+    }
+    arena_.Reset();
+}
+
+void MarketDataServerThread::publish_snapshots() {
+    int64_t timestamp = now_us();
+    
+    for (const auto& [symbol, book] : books_) {
+        auto& message = *google::protobuf::Arena::CreateMessage<MarketDataMessage>(&arena_);
+        fill_snapshot(symbol, &book, timestamp, *message.mutable_book_snapshot());
+        
+        if (publisher_->publish_with_topic(book.topic, message)) {
+            snapshots_published_++;
+        }
+        arena_.Reset();
+    }
+}
+
+void MarketDataServerThread::serve_recovery() {
+    // REP is lockstep: one request, one reply, until none are waiting
+    while (true) {
+        auto& request = *google::protobuf::Arena::CreateMessage<SnapshotRequest>(&arena_);
+        if (!recovery_->receive_request(request, 0)) {
+            arena_.Reset();
+            return;
+        }
+        
+        // Unknown symbol: an empty book at sequence 0
+        auto it = books_.find(request.symbol());
+        const SymbolBook* book = it != books_.end() ? &it->second : nullptr;
+        
+        auto& reply = *google::protobuf::Arena::CreateMessage<MarketDataMessage>(&arena_);
+        fill_snapshot(request.symbol(), book, now_us(), *reply.mutable_book_snapshot());
+        recovery_->send_response(reply);
+        arena_.Reset();
+    }
+}
+
+void MarketDataServerThread::fill_snapshot(const std::string& symbol, const SymbolBook* book,
+                                           int64_t timestamp_us, BookSnapshot& snapshot) const {
+    snapshot.set_symbol(symbol);
+    snapshot.set_sequence(book ? book->sequence : 0);
+    snapshot.set_timestamp_us(timestamp_us);
+    
+    OrderBook* pb_book = snapshot.mutable_book();
+    pb_book->set_symbol(symbol);
+    pb_book->set_timestamp(timestamp_us / 1000);
+    pb_book->set_depth(config_.market_data_depth);
+    if (book) {
+        add_levels(book->bids, *pb_book->mutable_bids());
+        add_levels(book->asks, *pb_book->mutable_asks());
+    }
+}
+
+void MarketDataServerThread::publish_quotes() {
+    price_cache_->for_each([this](const std::string& symbol, const models::SymbolPriceData& data) {
+        models::QuoteSnapshot quote;
+        uint64_t version = data.read_quote(quote);
+        QuoteState& sent = quotes_[&data];
+        if (version == sent.version) {
+            return;  // Unchanged since the last one we sent
+        }
+        sent.version = version;
+        if (sent.topic.empty()) {
+            sent.topic = market_data_topic(kQuoteTopicPrefix, symbol);
+        }
+        
+        auto& message = *google::protobuf::Arena::CreateMessage<MarketDataMessage>(&arena_);
+        Quote* pb_quote = message.mutable_quote();
+        pb_quote->set_symbol(symbol);
+        pb_quote->set_timestamp(quote.timestamp);
+        pb_quote->set_bid_price(quote.bid);
+        pb_quote->set_bid_quantity(quote.bid_quantity);
+        pb_quote->set_ask_price(quote.ask);
+        pb_quote->set_ask_quantity(quote.ask_quantity);
+        pb_quote->set_spread(quote.bid > 0.0 && quote.ask > 0.0 ? quote.ask - quote.bid : 0.0);
+        
+        if (publisher_->publish_with_topic(sent.topic, message)) {
+            quotes_published_++;
+        }
+        arena_.Reset();
+    });
+}
+
+} // namespace marketsim::exchange::threads
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "pipeline_types.h"
+#include "exchange/config/exchange_config.h"
+#include "exchange/models/price_cache.h"
+#include "io_handler/io_context.h"
+#include "io_handler/zmq_publisher.h"
+#include "io_handler/zmq_replier.h"
+#include <google/protobuf/arena.h>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace marketsim::exchange::threads {
+
+/**
+ * @brief Thread that publishes the L2 market data feed
+ *
+ * Consumes book deltas and fills from all matching threads and publishes them
+ * on a PUB socket as sequenced BookUpdate messages, topic "BOOK.<symbol>\0"
+ * (see market_data_topic). It keeps its
+ * own copy of each published book (built from the deltas alone), so the periodic
+ * BookSnapshot for late joiners costs the matching threads nothing.
+ *
+ * Late joiners subscribe, buffer updates until a snapshot arrives, drop updates
+ * with sequence <= snapshot.sequence and apply the rest in order. Instead of
+ * waiting for the periodic snapshot, a client that joins late or sees a gap can
+ * ask the recovery REP endpoint (SnapshotRequest -> MarketDataMessage) for one.
+ *
+ * With a PriceCache it also publishes a conflated top-of-book Quote per symbol
+ * (topic "QUOTE.<symbol>\0"): every quote_interval_ms (or on every change when 0)
+ * it reads the latest BBO and sends it only if it changed, so a slow consumer
+ * never has a backlog of stale quotes, just the latest one.
+ */
+class MarketDataServerThread {
+public:
+    /**
+     * @brief Construct the market data thread (binds the PUB and recovery sockets)
+     * @param io_context ZeroMQ context
+     * @param config Exchange configuration (endpoint, depth, snapshot period)
+     * @param events Queue filled by the matching threads (not owned)
+     * @param price_cache Source of the Quote feed (not owned; nullptr = no quotes)
+     */
+    MarketDataServerThread(
+        io_handler::IOContext& io_context,
+        const config::ExchangeConfig& config,
+        MarketDataQueue& events,
+        models::PriceCache* price_cache = nullptr
+    );
+    
+    ~MarketDataServerThread();
+    
+    /**
+     * @brief Start publishing
+     */
+    void start();
+    
+    /**
+     * @brief Stop publishing
+     */
+    void stop();
+    
+    /**
+     * @brief Check if thread is running
+     */
+    bool is_running() const { return running_; }
+    
+    /**
+     * @brief Number of BookUpdate messages published
+     */
+    uint64_t updates_published() const { return updates_published_; }
+    
+    /**
+     * @brief Number of BookSnapshot messages published
+     */
+    uint64_t snapshots_published() const { return snapshots_published_; }
+    
+    /**
+     * @brief Number of Quote messages published
+     */
+    uint64_t quotes_published() const { return quotes_published_; }
+    
+private:
+    // Published view of one symbol's book, price -> level
+    struct SymbolBook {
+        std::string topic;    // Built once: updates and snapshots go out on it
+        uint64_t sequence = 0;
+        std::map<double, operations::LevelSnapshot, std::greater<double>> bids;
+        std::map<double, operations::LevelSnapshot> asks;
+    };
+    
+    // Events taken off the ring per wakeup
+    static constexpr size_t kBatchSize = 64;
+    
+    // First arena block; one update or snapshot fits comfortably
+    static constexpr size_t kArenaBlock = 64 * 1024;
+    
+    // Longest a recovery request waits while the feed is idle
+    static constexpr std::chrono::milliseconds kRecoveryPoll{10};
+    
+    void run();
+    void publish_update(MarketDataEvent& event);
+    void publish_snapshots();
+    void publish_quotes();
+    void serve_recovery();
+    void fill_snapshot(const std::string& symbol, const SymbolBook* book, int64_t timestamp_us,
+                       BookSnapshot& snapshot) const;
+    
+    config::ExchangeConfig config_;
+    
+    // Shared queue (not owned by this thread)
+    MarketDataQueue& events_;
+    std::vector<MarketDataEvent> batch_;
+    
+    std::unique_ptr<io_handler::ZmqPublisher> publisher_;
+    std::unique_ptr<io_handler::ZmqReplier> recovery_;
+    std::unordered_map<std::string, SymbolBook> books_;
+    
+    // Quote feed: last quote version sent per symbol, and its topic
+    struct QuoteState {
+        uint64_t version = 0;
+        std::string topic;
+    };
+    models::PriceCache* price_cache_;
+    std::unordered_map<const models::SymbolPriceData*, QuoteState> quotes_;
+    
+    // Each outgoing message is built here and reset once sent
+    std::unique_ptr<char[]> arena_block_;
+    google::protobuf::Arena arena_;
+    
+    // State
+    std::atomic<uint64_t> updates_published_;
+    std::atomic<uint64_t> snapshots_published_;
+    std::atomic<uint64_t> quotes_published_;
+    
+    // Threading
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<bool> running_;
+};
+
+} // namespace marketsim::exchange::threads
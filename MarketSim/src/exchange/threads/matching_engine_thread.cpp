@@ -0,0 +1,531 @@
+#include "matching_engine_thread.h"
+#include "exchange/utils/thread_affinity.h"
+#include "monitor/monitor_helpers.h"
+#include "io_handler/message_serializer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+namespace marketsim::exchange::threads {
+
+namespace {
+
+// Levels per side when the request doesn't say
+constexpr int kDefaultStatusDepth = 5;
+
+// Append the ticks after the cursors; returns false if since_seq had
+// already fallen out of the retained history (ticks were lost)
+bool append_ticks(const data::PriceHistory& history, uint64_t since_seq, int64_t since_ts,
+                  google::protobuf::RepeatedPtrField<PriceTick>* out) {
+    if (since_seq > history.last_sequence()) {
+        since_seq = 0;  // Cursor from before an exchange restart
+    }
+    
+    const auto& ticks = history.get_all();
+    size_t begin = history.first_after(since_seq, since_ts);
+    out->Reserve(static_cast<int>(ticks.size() - begin));
+    for (size_t i = begin; i < ticks.size(); ++i) {
+        auto* pb_tick = out->Add();
+        pb_tick->set_price(ticks[i].price);
+        pb_tick->set_timestamp_ms(ticks[i].timestamp_ms);
+        pb_tick->set_sequence(ticks[i].sequence);
+    }
+    return since_seq == 0 || ticks.empty() || since_seq + 1 >= ticks.front().sequence;
+}
+
+}
+
+MatchingEngineThread::MatchingEngineThread(
+    size_t shard_id,
+    const config::ExchangeConfig& config,
+    ResponseQueue& responses,
+    MarketDataQueue* market_data,
+    models::PriceCache* price_cache,
+    repository::OrderBookSnapshotRepository* snapshots)
+    : shard_id_(shard_id)
+    , config_(config)
+    , requests_(config.queue_capacity, config.queue_wait)
+    , responses_(responses)
+    , market_data_(market_data)
+    , market_data_pool_(market_data
+        ? std::make_unique<MarketDataPool>(config.queue_capacity, common::concurrency::WaitStrategy::YIELD)
+        : nullptr)
+    , price_cache_(price_cache)
+    , snapshots_(snapshots)
+    , batch_(kBatchSize)
+    , status_arena_block_(std::make_unique<char[]>(kStatusArenaBlock))
+    , status_arena_(status_arena_block_.get(), kStatusArenaBlock)
+    , applied_sequence_(0)
+    , snapshot_round_(0)
+    , last_snapshot_round_(0)
+    , snapshot_next_(0)
+    , queue_latency_(monitor::StatusMonitor::instance().register_latency("queue_wait"))
+    , match_latency_(monitor::StatusMonitor::instance().register_latency("match"))
+    , batch_latency_(monitor::StatusMonitor::instance().register_latency("match_batch"))
+    , orders_processed_(0)
+    , market_data_dropped_(0)
+    , running_(false)
+{
+}
+
+MatchingEngineThread::~MatchingEngineThread() {
+    stop();
+}
+
+void MatchingEngineThread::start() {
+    if (running_) {
+        return;
+    }
+    
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&MatchingEngineThread::run, this);
+}
+
+void MatchingEngineThread::stop() {
+    running_ = false;
+    
+    // Wake up if blocked
+    requests_.stop();
+    
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+}
+
+void MatchingEngineThread::run() {
+    monitor::MonitoredThread monitor("Exchange_Matching_" + std::to_string(shard_id_));
+    
+    if (config_.pin_threads) {
+        // Core 0 is left to the ingest/response threads and the OS
+        if (!utils::pin_current_thread(shard_id_ + 1)) {
+            std::cerr << "[MATCHING " << shard_id_ << "] Could not pin thread\n";
+        }
+    }
+    
+    while (running_) {
+        monitor.update_state(monitor::ThreadState::IDLE);
+        size_t count = requests_.pop_batch_for(batch_.data(), batch_.size(), std::chrono::milliseconds(100));
+        if (count == 0) {
+            capture_snapshot(SIZE_MAX);  // Nothing waiting: finish a round in one go
+            continue;
+        }
+        
+        monitor.update_state(monitor::ThreadState::RUNNING);
+        for (size_t i = 0; i < count; ++i) {
+            switch (batch_[i].channel) {
+                case ResponseChannel::ORDER:
+                    handle_order(batch_[i]);
+                    break;
+                case ResponseChannel::BATCH:
+                    handle_batch(batch_[i]);
+                    break;
+                case ResponseChannel::STATUS:
+                    handle_status(batch_[i]);
+                    break;
+            }
+            monitor.increment_tasks();
+        }
+        
+        // Busy: at most one book per batch, so no request waits behind a whole round
+        capture_snapshot(1);
+    }
+}
+
+void MatchingEngineThread::capture_snapshot(size_t max_symbols) {
+    if (!snapshots_) {
+        return;
+    }
+    
+    if (snapshot_round_ == 0) {
+        uint64_t round = snapshots_->requested_round();
+        if (round == last_snapshot_round_) {
+            return;
+        }
+        snapshot_round_ = round;
+        snapshot_next_ = 0;
+        snapshot_sections_.clear();
+    }
+    
+    // Each book is tagged with the journal position it was copied at, so books
+    // copied a few batches apart are each consistent on their own
+    for (; max_symbols > 0 && snapshot_next_ < symbols_.size(); --max_symbols, ++snapshot_next_) {
+        const auto& symbol_data = *symbols_[snapshot_next_];
+        snapshot_sections_.emplace_back();
+        repository::encode_book(*symbol_data.engine, applied_sequence_, symbol_data.order_count,
+                                snapshot_sections_.back());
+    }
+    
+    // Symbols created meanwhile are appended to symbols_, so they are picked up too.
+    // Any created later come from records after applied_sequence_, which is
+    // reported even with no books so recovery replays from there
+    if (snapshot_next_ == symbols_.size()) {
+        snapshots_->submit(snapshot_round_, applied_sequence_, std::move(snapshot_sections_));
+        snapshot_sections_.clear();
+        last_snapshot_round_ = snapshot_round_;
+        snapshot_round_ = 0;
+    }
+}
+
+void MatchingEngineThread::restore(const repository::BookImage& image) {
+    auto& symbol_data = get_or_create_symbol(image.symbol);
+    repository::restore_book(image, *symbol_data.engine);
+    symbol_data.order_count = static_cast<int>(image.orders_received);
+    symbol_data.snapshot_sequence = image.journal_sequence;
+    applied_sequence_ = std::max(applied_sequence_, image.journal_sequence);
+}
+
+MatchingEngineThread::SymbolData* MatchingEngineThread::replay_target(uint64_t journal_sequence,
+                                                                      const std::string& symbol) {
+    auto& symbol_data = get_or_create_symbol(symbol);
+    if (journal_sequence <= symbol_data.snapshot_sequence) {
+        return nullptr;
+    }
+    applied_sequence_ = std::max(applied_sequence_, journal_sequence);
+    return &symbol_data;
+}
+
+bool MatchingEngineThread::replay(uint64_t journal_sequence, const Order& order) {
+    SymbolData* symbol_data = replay_target(journal_sequence, order.symbol());
+    if (!symbol_data) {
+        return false;
+    }
+    
+    symbol_data->order_count++;
+    symbol_data->last_received_order = order;
+    advance_clock(*symbol_data, order.timestamp());
+    fills_.clear();
+    symbol_data->engine->match_order(order, fills_);
+    orders_processed_++;
+    return true;
+}
+
+bool MatchingEngineThread::replay(uint64_t journal_sequence, const OrderBatch& batch) {
+    if (batch.orders_size() == 0) {
+        return false;
+    }
+    SymbolData* symbol_data = replay_target(journal_sequence, batch.symbol());
+    if (!symbol_data) {
+        return false;
+    }
+    
+    symbol_data->order_count += batch.orders_size();
+    symbol_data->last_received_order = batch.orders(batch.orders_size() - 1);
+    advance_clock(*symbol_data, symbol_data->last_received_order.timestamp());
+    fills_.clear();
+    symbol_data->engine->match_batch(
+        { batch.orders().data(), static_cast<size_t>(batch.orders_size()) },
+        fills_, batch_results_);
+    orders_processed_ += batch.orders_size();
+    return true;
+}
+
+MatchingEngineThread::SymbolData& MatchingEngineThread::get_or_create_symbol(const std::string& symbol) {
+    utils::InternId id = symbol_ids_.intern(symbol);
+    if (id == symbols_.size()) {
+        symbols_.push_back(std::make_unique<SymbolData>(symbol, config_, price_cache_));
+    }
+    return *symbols_[id];
+}
+
+void MatchingEngineThread::handle_order(PipelineRequest& request) {
+    const Order& order = request.order;
+    queue_latency_->record(std::chrono::steady_clock::now() - request.received_at);
+    
+    // Get or create symbol data
+    auto& symbol_data = get_or_create_symbol(order.symbol());
+    
+    symbol_data.order_count++;
+    symbol_data.last_received_order = order;
+    advance_clock(symbol_data, order.timestamp());
+    
+    // Process order - fills stay as POD records; nothing here needs wire Trades
+    fills_.clear();
+    auto match_start = std::chrono::steady_clock::now();
+    auto match_result = symbol_data.engine->match_order(order, fills_);
+    match_latency_->record(std::chrono::steady_clock::now() - match_start);
+    orders_processed_++;
+    applied_sequence_ = std::max(applied_sequence_, request.journal_sequence);
+    
+    // Queue acknowledgement for the response thread
+    PipelineResponse response;
+    response.channel = ResponseChannel::ORDER;
+    response.envelope = std::move(request.envelope);
+    response.received_at = request.received_at;
+    response.journal_sequence = request.journal_sequence;
+    response.ack.set_order_id(order.order_id());
+    response.ack.set_status(match_result.success ? 
+        OrderStatus::ACCEPTED : 
+        OrderStatus::REJECTED);
+    response.ack.set_message(match_result.success ? "OK" : match_result.error_message);
+    response.ack.set_timestamp(order.timestamp());
+    
+    responses_.push(std::move(response));
+    
+    // Feed after the ack so the client hears first
+    update_price_cache(symbol_data);
+    publish_market_data(symbol_data);
+}
+
+void MatchingEngineThread::handle_batch(PipelineRequest& request) {
+    const OrderBatch& batch = request.batch;
+    queue_latency_->record(std::chrono::steady_clock::now() - request.received_at);
+    
+    PipelineResponse response;
+    response.channel = ResponseChannel::BATCH;
+    response.envelope = std::move(request.envelope);
+    response.received_at = request.received_at;
+    response.journal_sequence = request.journal_sequence;
+    OrderAckBatch& acks = response.ack_batch;
+    acks.set_batch_id(batch.batch_id());
+    
+    SymbolData* matched = nullptr;
+    if (batch.orders_size() > 0) {
+        auto& symbol_data = get_or_create_symbol(batch.symbol());
+        matched = &symbol_data;
+        
+        symbol_data.order_count += batch.orders_size();
+        symbol_data.last_received_order = batch.orders(batch.orders_size() - 1);
+        advance_clock(symbol_data, symbol_data.last_received_order.timestamp());
+        
+        // Whole cloud in one engine pass
+        fills_.clear();
+        auto match_start = std::chrono::steady_clock::now();
+        symbol_data.engine->match_batch(
+            { batch.orders().data(), static_cast<size_t>(batch.orders_size()) },
+            fills_, batch_results_);
+        batch_latency_->record(std::chrono::steady_clock::now() - match_start);
+        orders_processed_ += batch.orders_size();
+        applied_sequence_ = std::max(applied_sequence_, request.journal_sequence);
+        
+        for (size_t i = 0; i < batch_results_.size(); ++i) {
+            const auto& result = batch_results_[i];
+            acks.add_statuses(result.success ? OrderStatus::ACCEPTED : OrderStatus::REJECTED);
+            if (!result.success) {
+                auto* reject = acks.add_rejects();
+                reject->set_index(static_cast<uint32_t>(i));
+                reject->set_message(result.error);
+            }
+        }
+    }
+    
+    acks.set_timestamp(matched ? now_ms(*matched) : data::PriceTick::now_ms());
+    responses_.push(std::move(response));
+    
+    // One feed update for the whole batch
+    if (matched) {
+        update_price_cache(*matched);
+        publish_market_data(*matched);
+    }
+}
+
+void MatchingEngineThread::advance_clock(SymbolData& symbol_data, int64_t timestamp_ms) {
+    if (config_.clock_mode != common::clock::ClockMode::VIRTUAL) {
+        return;
+    }
+    // Never backwards; orders without a timestamp leave the engine on the wall clock
+    symbol_data.event_time_ms = std::max(symbol_data.event_time_ms, timestamp_ms);
+    if (symbol_data.event_time_ms > 0) {
+        symbol_data.engine->set_time(symbol_data.event_time_ms * 1000000);
+    }
+}
+
+int64_t MatchingEngineThread::now_ms(const SymbolData& symbol_data) const {
+    if (config_.clock_mode == common::clock::ClockMode::VIRTUAL && symbol_data.event_time_ms > 0) {
+        return symbol_data.event_time_ms;
+    }
+    return data::PriceTick::now_ms();
+}
+
+void MatchingEngineThread::update_price_cache(SymbolData& symbol_data) {
+    if (!symbol_data.prices) {
+        return;
+    }
+    
+    models::SymbolPriceData& prices = *symbol_data.prices;
+    const auto& book = symbol_data.engine->get_order_book();
+    for (const auto& fill : fills_) {
+        prices.update_trade(book.to_price(fill.price_ticks), fill.quantity, fill.timestamp / 1000000);
+    }
+    
+    // Only a real change bumps the quote version (what the Quote feed conflates on)
+    double bid = 0.0, bid_qty = 0.0, ask = 0.0, ask_qty = 0.0;
+    book.get_best_bid(bid, bid_qty);
+    book.get_best_ask(ask, ask_qty);
+    if (bid != prices.best_bid.load(std::memory_order_relaxed) ||
+        bid_qty != prices.best_bid_quantity.load(std::memory_order_relaxed) ||
+        ask != prices.best_ask.load(std::memory_order_relaxed) ||
+        ask_qty != prices.best_ask_quantity.load(std::memory_order_relaxed)) {
+        prices.update_quote(bid, bid_qty, ask, ask_qty, now_ms(symbol_data));
+    }
+}
+
+void MatchingEngineThread::publish_market_data(SymbolData& symbol_data) {
+    if (!market_data_) {
+        return;
+    }
+    
+    // Filled in place: a recycled event already has the capacity it needs
+    const auto& book = symbol_data.engine->get_order_book();
+    MarketDataEvent& event = market_data_event_;
+    event.levels.clear();
+    symbol_data.book_deltas.diff(book, event.levels);
+    if (event.levels.empty() && fills_.empty() && !symbol_data.feed_reset) {
+        return;  // e.g. a reject: nothing visible changed
+    }
+    
+    event.symbol = book.get_symbol();
+    event.sequence = ++symbol_data.feed_sequence;
+    event.timestamp_us = config_.clock_mode == common::clock::ClockMode::VIRTUAL
+        ? now_ms(symbol_data) * 1000
+        : std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::system_clock::now().time_since_epoch()).count();
+    event.tick_size = book.tick_size();
+    event.reset = symbol_data.feed_reset;
+    event.trades.assign(fills_.begin(), fills_.end());
+    event.pool = market_data_pool_.get();
+    
+    // Matching never waits on the feed. A dropped update leaves a gap in the
+    // sequence (subscribers recover from a snapshot) and the next one carries
+    // the whole tracked depth, so the market data thread's book heals too.
+    if (!market_data_->try_push(std::move(event))) {
+        market_data_dropped_++;
+        symbol_data.book_deltas.reset();
+        symbol_data.feed_reset = true;
+        return;
+    }
+    symbol_data.feed_reset = false;
+    
+    // Refill from a spent event; with none back yet the next one starts empty
+    market_data_pool_->try_pop(market_data_event_);
+}
+
+void MatchingEngineThread::handle_status(PipelineRequest& request) {
+    const std::string& requested_symbol = request.status_request.symbol();
+    
+    // Build status response - FILTER BY REQUESTED SYMBOL
+    // The whole tree (hundreds of ticks plus the book) lives on the arena
+    StatusResponse& resp = *google::protobuf::Arena::CreateMessage<StatusResponse>(&status_arena_);
+    
+    utils::InternId symbol_id = symbol_ids_.find(requested_symbol);
+    if (symbol_id != utils::InternTable::npos) {
+        // Symbol exists - return its data
+        const auto& symbol_data = *symbols_[symbol_id];
+        
+        resp.set_total_orders_received(symbol_data.order_count);
+        resp.set_total_trades(symbol_data.engine->total_trades());
+        resp.set_total_volume(symbol_data.engine->total_volume());
+        
+        // Set last trade price from history
+        data::PriceTick last_trade;
+        if (symbol_data.engine->get_last_trade_price(last_trade)) {
+            resp.set_last_trade_price(last_trade.price);
+            resp.set_last_trade_timestamp(last_trade.timestamp_ms);
+        } else {
+            resp.set_last_trade_price(0.0);
+            resp.set_last_trade_timestamp(0);
+        }
+        
+        // Set mid price from history
+        data::PriceTick last_mid;
+        if (symbol_data.engine->get_last_mid_price(last_mid)) {
+            resp.set_mid_price(last_mid.price);
+            resp.set_mid_price_timestamp(last_mid.timestamp_ms);
+        } else {
+            resp.set_mid_price(0.0);
+            resp.set_mid_price_timestamp(0);
+        }
+        
+        // Only the ticks the poller hasn't seen yet
+        const StatusRequest& status_request = request.status_request;
+        const StatusFieldMask& fields = status_request.fields();
+        const auto& trade_history = symbol_data.engine->get_trade_price_history();
+        const auto& mid_history = symbol_data.engine->get_mid_price_history();
+        resp.set_trade_history_sequence(trade_history.last_sequence());
+        resp.set_mid_history_sequence(mid_history.last_sequence());
+        
+        bool complete = true;
+        if (!fields.skip_trade_history()) {
+            complete &= append_ticks(trade_history, status_request.since_trade_seq(),
+                                     status_request.since_ts_ms(), resp.mutable_trade_price_history());
+        }
+        if (!fields.skip_mid_history()) {
+            complete &= append_ticks(mid_history, status_request.since_mid_seq(),
+                                     status_request.since_ts_ms(), resp.mutable_mid_price_history());
+        }
+        resp.set_history_truncated(!complete);
+        
+        // Add last received order if available
+        if (symbol_data.order_count > 0) {
+            auto* last_order = resp.mutable_last_received_order();
+            last_order->CopyFrom(symbol_data.last_received_order);
+        }
+        
+        // Add orderbook snapshot for THIS SYMBOL ONLY
+        if (!fields.skip_orderbook()) {
+            int depth = fields.book_depth() > 0 ? fields.book_depth() : kDefaultStatusDepth;
+            const auto& order_book = symbol_data.engine->get_order_book();
+            auto buy_levels = order_book.get_buy_side(depth);
+            auto sell_levels = order_book.get_sell_side(depth);
+            
+            auto* ob = resp.mutable_current_orderbook();
+            ob->set_symbol(requested_symbol);
+            ob->set_timestamp(0);
+            
+            // Add buy side
+            for (const auto& level : buy_levels) {
+                auto* bid = ob->add_bids();
+                bid->set_price(level.price);
+                bid->set_quantity(level.quantity);
+                bid->set_order_count(static_cast<int>(level.order_count));
+            }
+            
+            // Add sell side
+            for (const auto& level : sell_levels) {
+                auto* ask = ob->add_asks();
+                ask->set_price(level.price);
+                ask->set_quantity(level.quantity);
+                ask->set_order_count(static_cast<int>(level.order_count));
+            }
+        }
+    } else {
+        // Symbol doesn't exist yet - return empty response
+        resp.set_total_orders_received(0);
+        resp.set_total_trades(0);
+        resp.set_total_volume(0.0);
+        resp.set_last_trade_price(0.0);
+        
+        auto* ob = resp.mutable_current_orderbook();
+        ob->set_symbol(requested_symbol);
+    }
+    
+    // Exchange-wide stage latencies, whichever symbol was asked for
+    if (!request.status_request.fields().skip_latency()) {
+        for (const auto& stage : monitor::StatusMonitor::instance().get_latency_status()) {
+            auto* pb_stage = resp.add_stage_latency();
+            pb_stage->set_stage(stage.stage);
+            pb_stage->set_count(stage.count);
+            pb_stage->set_mean_ns(stage.mean_ns);
+            pb_stage->set_p50_ns(stage.p50_ns);
+            pb_stage->set_p99_ns(stage.p99_ns);
+            pb_stage->set_p999_ns(stage.p999_ns);
+            pb_stage->set_max_ns(stage.max_ns);
+        }
+    }
+    
+    PipelineResponse response;
+    response.channel = ResponseChannel::STATUS;
+    try {
+        io_handler::MessageSerializer::serialize_to_frame(resp, response.status_payload);
+    } catch (const std::exception& e) {
+        // Still reply (empty) so the REP socket isn't left waiting
+        std::cerr << "[MATCHING " << shard_id_ << "] Status serialization failed: " << e.what() << "\n";
+    }
+    
+    // Drops every sub-message at once; the first block is kept for next time
+    status_arena_.Reset();
+    
+    responses_.push(std::move(response));
+}
+
+} // namespace marketsim::exchange::threads
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "pipeline_types.h"
+#include "exchange/operations/matching_engine.h"
+#include "exchange/config/exchange_config.h"
+#include "exchange/utils/intern_table.h"
+#include "exchange/models/price_cache.h"
+#include "exchange/repository/orderbook_snapshot_repository.h"
+#include "monitor/latency_histogram.h"
+#include <google/protobuf/arena.h>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace marketsim::exchange::threads {
+
+/**
+ * @brief One matching shard: owns the engines for a group of symbols
+ *
+ * The ingest thread routes every order and status request for a symbol to the
+ * same shard, so engines are only ever touched by their own thread and need no
+ * locking. Requests arrive on a private SPSC ring and are drained in batches;
+ * results go to the shared MPSC response ring.
+ *
+ * With a snapshot repository, the shard copies its books into snapshot
+ * sections when a round is requested: one symbol between batches while busy,
+ * all remaining ones when idle.
+ */
+class MatchingEngineThread {
+public:
+    /**
+     * @brief Construct a matching shard
+     * @param shard_id Index of this shard (also used for CPU pinning)
+     * @param config Exchange configuration (engine sizing, pinning)
+     * @param responses Queue read by the response thread (not owned)
+     * @param market_data Queue read by the market data thread (not owned; nullptr = no feed)
+     * @param price_cache Latest BBO/trade per symbol, kept current by this shard (not owned; optional)
+     * @param snapshots Book snapshot rounds to take part in (not owned; nullptr = off)
+     */
+    MatchingEngineThread(
+        size_t shard_id,
+        const config::ExchangeConfig& config,
+        ResponseQueue& responses,
+        MarketDataQueue* market_data = nullptr,
+        models::PriceCache* price_cache = nullptr,
+        repository::OrderBookSnapshotRepository* snapshots = nullptr
+    );
+
+    ~MatchingEngineThread();
+
+    /**
+     * @brief Start processing requests
+     */
+    void start();
+
+    /**
+     * @brief Stop processing (pending requests are dropped)
+     */
+    void stop();
+
+    /**
+     * @brief Check if thread is running
+     */
+    bool is_running() const { return running_; }
+
+    /**
+     * @brief Inbound queue for this shard (fed by the ingest thread)
+     */
+    RequestQueue& requests() { return requests_; }
+
+    /**
+     * @brief Number of orders processed
+     */
+    uint64_t orders_processed() const { return orders_processed_; }
+
+    /**
+     * @brief Number of feed updates dropped because the market data queue was full
+     */
+    uint64_t market_data_dropped() const { return market_data_dropped_; }
+
+    /**
+     * @brief Recovery (before start()): rebuild a symbol from its snapshot image
+     */
+    void restore(const repository::BookImage& image);
+
+    /**
+     * @brief Recovery (before start()): re-apply a journaled order or batch
+     * @return false if the symbol's snapshot already contained it
+     */
+    bool replay(uint64_t journal_sequence, const Order& order);
+    bool replay(uint64_t journal_sequence, const OrderBatch& batch);
+
+private:
+    // Order tracking per symbol
+    struct SymbolData {
+        std::unique_ptr<operations::MatchingEngine> engine;
+        int order_count;
+        Order last_received_order;
+
+        // Market data feed state
+        operations::BookDeltaTracker book_deltas;
+        uint64_t feed_sequence;
+        bool feed_reset;                   // An update was dropped: send the whole depth next
+        models::SymbolPriceData* prices;   // Entry in the shared PriceCache, or nullptr
+
+        // Journal records up to here are in the restored snapshot (recovery only)
+        uint64_t snapshot_sequence;
+
+        // Latest order timestamp (ms), the engine's time under a VIRTUAL clock
+        int64_t event_time_ms;
+
+        SymbolData(const std::string& symbol, const config::ExchangeConfig& config,
+                   models::PriceCache* price_cache)
+            : engine(std::make_unique<operations::MatchingEngine>(
+                symbol,
+                config.price_history_size,
+                config.tick_size_for(symbol),
+                config.ladder_levels,
+                config.order_pool_size))
+            , order_count(0)
+            , book_deltas(config.market_data_depth)
+            , feed_sequence(0)
+            , feed_reset(false)
+            , prices(price_cache ? price_cache->get_or_create(symbol) : nullptr)
+            , snapshot_sequence(0)
+            , event_time_ms(0)
+        {}
+    };
+
+    // Requests taken off the ring per wakeup
+    static constexpr size_t kBatchSize = 64;
+
+    // First arena block; sized so a full status tree normally fits without
+    // the arena having to go back to the heap
+    static constexpr size_t kStatusArenaBlock = 256 * 1024;
+    
+    void run();
+    void handle_order(PipelineRequest& request);
+    void handle_batch(PipelineRequest& request);
+    void handle_status(PipelineRequest& request);
+    
+    // VIRTUAL clock: move the symbol's time up to an order's timestamp
+    void advance_clock(SymbolData& symbol_data, int64_t timestamp_ms);
+    
+    // The symbol's time: its event time under a VIRTUAL clock, else the wall clock
+    int64_t now_ms(const SymbolData& symbol_data) const;
+    
+    // Queue the book changes and fills_ left by the last order/batch for the feed
+    // (never waits: with the queue full the update is dropped, leaving a sequence gap)
+    void publish_market_data(SymbolData& symbol_data);
+    
+    // Record fills_ and any BBO change in the shared PriceCache
+    void update_price_cache(SymbolData& symbol_data);
+
+    // Copy up to max_symbols books for a requested snapshot round; submits once all are done
+    void capture_snapshot(size_t max_symbols);
+
+    // Replayed record for symbol_data (nullptr if the snapshot already had it)
+    SymbolData* replay_target(uint64_t journal_sequence, const std::string& symbol);
+
+    SymbolData& get_or_create_symbol(const std::string& symbol);
+
+    size_t shard_id_;
+    config::ExchangeConfig config_;
+
+    // Queues
+    RequestQueue requests_;
+    ResponseQueue& responses_;
+    MarketDataQueue* market_data_;
+    std::unique_ptr<MarketDataPool> market_data_pool_;
+    MarketDataEvent market_data_event_;    // Next event to fill (recycled from the pool)
+    models::PriceCache* price_cache_;
+    repository::OrderBookSnapshotRepository* snapshots_;
+    std::vector<PipelineRequest> batch_;
+
+    // Symbol -> dense id; symbols_ is indexed by that id
+    utils::InternTable symbol_ids_;
+    std::vector<std::unique_ptr<SymbolData>> symbols_;
+
+    // Reused fill/result buffers for match_order and match_batch
+    std::vector<operations::Fill> fills_;
+    std::vector<operations::OrderResult> batch_results_;
+
+    // Status responses are built here and reset once serialized
+    std::unique_ptr<char[]> status_arena_block_;
+    google::protobuf::Arena status_arena_;
+
+    // Newest journal record matched here (requests arrive in journal order)
+    uint64_t applied_sequence_;
+
+    // Snapshot round in progress (0 = none): next symbol to copy and the copies so far
+    uint64_t snapshot_round_;
+    uint64_t last_snapshot_round_;
+    size_t snapshot_next_;
+    std::vector<std::string> snapshot_sections_;
+
+    // Stage latencies: time on the ring, and in the engine
+    std::shared_ptr<monitor::LatencyHistogram> queue_latency_;
+    std::shared_ptr<monitor::LatencyHistogram> match_latency_;
+    std::shared_ptr<monitor::LatencyHistogram> batch_latency_;
+
+    // State
+    std::atomic<uint64_t> orders_processed_;
+    std::atomic<uint64_t> market_data_dropped_;
+
+    // Threading
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<bool> running_;
+};
+
+} // namespace marketsim::exchange::threads
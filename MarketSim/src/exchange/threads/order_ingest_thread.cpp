@@ -0,0 +1,258 @@
+#include "order_ingest_thread.h"
+#include "monitor/monitor_helpers.h"
+#include <chrono>
+#include <functional>
+#include <iostream>
+
+namespace marketsim::exchange::threads {
+
+namespace {
+
+// Orders (or batches) drained per wakeup before servicing the other sockets
+constexpr int kMaxOrdersPerPoll = 256;
+constexpr int kMaxBatchesPerPoll = 32;
+
+}
+
+OrderIngestThread::OrderIngestThread(
+    io_handler::IOContext& io_context,
+    const config::ExchangeConfig& config,
+    const std::vector<MatchingEngineThread*>& shards,
+    repository::OrderRepository* journal)
+    : response_socket_(io_context.get_context(), zmq::socket_type::pull)
+    , shards_(shards)
+    , journal_(journal)
+    , sync_journal_(journal && journal->durability() == repository::DurabilityMode::SYNC)
+    , decode_latency_(monitor::StatusMonitor::instance().register_latency("decode"))
+    , journal_latency_(monitor::StatusMonitor::instance().register_latency("journal"))
+    , send_latency_(monitor::StatusMonitor::instance().register_latency("send"))
+    , orders_received_(0)
+    , running_(false)
+{
+    order_router_ = std::make_unique<io_handler::ZmqRouter>(io_context, "Exchange_Orders", config.order_port);
+    order_router_->bind();
+    
+    batch_router_ = std::make_unique<io_handler::ZmqRouter>(io_context, "Exchange_Batches", config.batch_port);
+    batch_router_->bind();
+    
+    status_replier_ = std::make_unique<io_handler::ZmqReplier>(io_context, "Exchange_Status", config.status_port);
+    status_replier_->bind();
+    
+    // Bound before the response thread connects
+    response_socket_.set(zmq::sockopt::linger, 0);
+    response_socket_.bind(kResponseEndpoint);
+    
+    // Replies first: they complete work that is already in flight
+    reactor_.add(response_socket_, [this] { forward_responses(); });
+    reactor_.add(order_router_->socket(), [this] { receive_orders(); },
+                 [this] { return !stalled_; });
+    reactor_.add(batch_router_->socket(), [this] { receive_batches(); },
+                 [this] { return !stalled_; });
+    // REP is lockstep: no new status request until the reply went out
+    reactor_.add(status_replier_->socket(), [this] { receive_status(); },
+                 [this] { return !stalled_ && !status_replier_->awaiting_response(); });
+}
+
+OrderIngestThread::~OrderIngestThread() {
+    stop();
+    response_socket_.close();
+}
+
+void OrderIngestThread::start() {
+    if (running_) {
+        return;
+    }
+    
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&OrderIngestThread::run, this);
+}
+
+void OrderIngestThread::stop() {
+    running_ = false;
+    
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+}
+
+size_t OrderIngestThread::shard_for(const std::string& symbol) const {
+    return shard_for_symbol(symbol, shards_.size());
+}
+
+void OrderIngestThread::run() {
+    monitor::MonitoredThread monitor("Exchange_Ingest");
+    
+    while (running_) {
+        // A full shard ring stops intake until it drains (replies keep flowing)
+        if (stalled_) {
+            route(std::move(*stalled_));
+        }
+        
+        monitor.update_state(monitor::ThreadState::IDLE);
+        try {
+            reactor_.wait(std::chrono::milliseconds(stalled_ ? 1 : 100));
+        } catch (const zmq::error_t& e) {
+            std::cerr << "[INGEST] Poll failed: " << e.what() << "\n";
+            continue;
+        }
+        monitor.update_state(monitor::ThreadState::RUNNING);
+        
+        reactor_.dispatch();
+    }
+}
+
+bool OrderIngestThread::route(PipelineRequest&& request) {
+    const std::string* symbol = &request.status_request.symbol();
+    if (request.channel == ResponseChannel::ORDER) {
+        symbol = &request.order.symbol();
+    } else if (request.channel == ResponseChannel::BATCH) {
+        symbol = &request.batch.symbol();
+    }
+    
+    // try_push leaves request untouched on failure
+    if (shards_[shard_for(*symbol)]->requests().try_push(std::move(request))) {
+        stalled_.reset();
+        return true;
+    }
+    
+    if (!stalled_) {
+        stalled_.emplace(std::move(request));
+    }
+    return false;
+}
+
+uint64_t OrderIngestThread::journal(repository::JournalRecordType type, const google::protobuf::MessageLite& message) {
+    if (!journal_) {
+        return 0;
+    }
+    
+    monitor::ScopedLatency timer(*journal_latency_);
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    uint64_t sequence = journal_->append(type, message, now_ns);
+    if (sequence == 0 && journal_->append_failures() == 1) {
+        std::cerr << "[INGEST] Journal append failed; continuing without a record\n";
+    }
+    return sequence;
+}
+
+void OrderIngestThread::reject_unjournaled(const PipelineRequest& request) {
+    constexpr const char* kReason = "Not accepted: order journal unavailable";
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    if (request.channel == ResponseChannel::ORDER) {
+        OrderAck ack;
+        ack.set_order_id(request.order.order_id());
+        ack.set_status(OrderStatus::REJECTED);
+        ack.set_message(kReason);
+        ack.set_timestamp(now_ms);
+        order_router_->send(request.envelope, ack);
+        return;
+    }
+    
+    OrderAckBatch acks;
+    acks.set_batch_id(request.batch.batch_id());
+    acks.set_timestamp(now_ms);
+    for (int i = 0; i < request.batch.orders_size(); ++i) {
+        acks.add_statuses(OrderStatus::REJECTED);
+        auto* reject = acks.add_rejects();
+        reject->set_index(static_cast<uint32_t>(i));
+        reject->set_message(kReason);
+    }
+    batch_router_->send(request.envelope, acks);
+}
+
+void OrderIngestThread::receive_orders() {
+    for (int i = 0; i < kMaxOrdersPerPoll; ++i) {
+        PipelineRequest request;
+        request.channel = ResponseChannel::ORDER;
+        auto start = std::chrono::steady_clock::now();
+        if (!order_router_->receive(request.envelope, request.order, 0)) {
+            break;
+        }
+        request.received_at = std::chrono::steady_clock::now();
+        decode_latency_->record(request.received_at - start);
+        request.journal_sequence = journal(repository::JournalRecordType::ORDER, request.order);
+        if (sync_journal_ && request.journal_sequence == 0) {
+            reject_unjournaled(request);
+            continue;
+        }
+        
+        orders_received_++;
+        if (!route(std::move(request))) {
+            break;
+        }
+    }
+}
+
+void OrderIngestThread::receive_batches() {
+    for (int i = 0; i < kMaxBatchesPerPoll; ++i) {
+        PipelineRequest request;
+        request.channel = ResponseChannel::BATCH;
+        auto start = std::chrono::steady_clock::now();
+        if (!batch_router_->receive(request.envelope, request.batch, 0)) {
+            break;
+        }
+        request.received_at = std::chrono::steady_clock::now();
+        decode_latency_->record(request.received_at - start);
+        request.journal_sequence = journal(repository::JournalRecordType::BATCH, request.batch);
+        if (sync_journal_ && request.journal_sequence == 0) {
+            reject_unjournaled(request);
+            continue;
+        }
+        
+        orders_received_ += request.batch.orders_size();
+        if (!route(std::move(request))) {
+            break;
+        }
+    }
+}
+
+void OrderIngestThread::receive_status() {
+    PipelineRequest request;
+    request.channel = ResponseChannel::STATUS;
+    if (!status_replier_->receive_request(request.status_request, 0)) {
+        return;
+    }
+    
+    route(std::move(request));
+}
+
+void OrderIngestThread::forward_responses() {
+    while (true) {
+        // Frames: [channel][identity][delimited][payload]
+        zmq::message_t channel_frame;
+        try {
+            if (!response_socket_.recv(channel_frame, zmq::recv_flags::dontwait)) {
+                return;
+            }
+            
+            zmq::message_t identity_frame;
+            zmq::message_t delimited_frame;
+            zmq::message_t payload_frame;
+            response_socket_.recv(identity_frame, zmq::recv_flags::none);
+            response_socket_.recv(delimited_frame, zmq::recv_flags::none);
+            response_socket_.recv(payload_frame, zmq::recv_flags::none);
+            
+            // The payload frame is handed on as-is: no copy on the way out
+            auto channel = static_cast<ResponseChannel>(*static_cast<const uint8_t*>(channel_frame.data()));
+            
+            if (channel == ResponseChannel::STATUS) {
+                status_replier_->send_frame(payload_frame);
+            } else {
+                io_handler::RoutingEnvelope envelope;
+                envelope.identity.assign(static_cast<const char*>(identity_frame.data()), identity_frame.size());
+                envelope.delimited = *static_cast<const uint8_t*>(delimited_frame.data()) != 0;
+                auto& router = channel == ResponseChannel::BATCH ? batch_router_ : order_router_;
+                monitor::ScopedLatency timer(*send_latency_);
+                router->send_frame(envelope, payload_frame);
+            }
+        } catch (const zmq::error_t& e) {
+            std::cerr << "[INGEST] Forward failed: " << e.what() << "\n";
+            return;
+        }
+    }
+}
+
+} // namespace marketsim::exchange::threads
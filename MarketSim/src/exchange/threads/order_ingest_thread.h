@@ -0,0 +1,125 @@
+#pragma once
+
+#include "pipeline_types.h"
+#include "matching_engine_thread.h"
+#include "exchange/config/exchange_config.h"
+#include "exchange/repository/order_repository.h"
+#include "io_handler/io_context.h"
+#include "io_handler/zmq_router.h"
+#include "io_handler/zmq_replier.h"
+#include "io_handler/zmq_reactor.h"
+#include "monitor/latency_histogram.h"
+#include <zmq.hpp>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace marketsim::exchange::threads {
+
+/**
+ * @brief Thread that owns the client-facing sockets
+ * 
+ * Receives orders and order batches (ROUTER) and status requests (REP),
+ * routes each to the matching shard that owns its symbol, and sends back the
+ * serialized replies the response thread pushes over inproc. All sockets sit
+ * in one reactor, so whichever is ready is served immediately. Never blocks on
+ * matching, so many orders can be in flight at once.
+ *
+ * With a journal, every order and batch is appended to it as it is decoded,
+ * before it is routed: the ingest thread sees the whole stream in arrival
+ * order, so the journal has one writer and one sequence. With a SYNC journal
+ * a request that could not be appended is rejected here and never matched.
+ */
+class OrderIngestThread {
+public:
+    /**
+     * @brief Construct ingest thread and bind its sockets
+     * @param io_context ZeroMQ context
+     * @param config Exchange configuration (ports)
+     * @param shards Matching shards, indexed by shard id (not owned)
+     * @param journal Order journal to append to (not owned; nullptr = off)
+     * @throws zmq::error_t if a socket cannot be bound
+     */
+    OrderIngestThread(
+        io_handler::IOContext& io_context,
+        const config::ExchangeConfig& config,
+        const std::vector<MatchingEngineThread*>& shards,
+        repository::OrderRepository* journal = nullptr
+    );
+    
+    ~OrderIngestThread();
+    
+    /**
+     * @brief Start receiving requests
+     */
+    void start();
+    
+    /**
+     * @brief Stop receiving requests
+     */
+    void stop();
+    
+    /**
+     * @brief Check if thread is running
+     */
+    bool is_running() const { return running_; }
+    
+    /**
+     * @brief Get number of orders routed
+     */
+    uint64_t orders_received() const { return orders_received_; }
+    
+private:
+    void run();
+    void receive_orders();
+    void receive_batches();
+    void receive_status();
+    void forward_responses();
+    
+    // Hand a request to its shard; keeps it in stalled_ if the ring is full
+    bool route(PipelineRequest&& request);
+    size_t shard_for(const std::string& symbol) const;
+    
+    // Journal a decoded request; its sequence, or 0 when journaling is off or failed
+    uint64_t journal(repository::JournalRecordType type, const google::protobuf::MessageLite& message);
+    
+    // SYNC journal only: reject a request the journal could not take
+    void reject_unjournaled(const PipelineRequest& request);
+    
+    // Client-facing sockets
+    std::unique_ptr<io_handler::ZmqRouter> order_router_;
+    std::unique_ptr<io_handler::ZmqRouter> batch_router_;
+    std::unique_ptr<io_handler::ZmqReplier> status_replier_;
+    
+    // Inproc PULL from the response thread
+    zmq::socket_t response_socket_;
+    
+    // Polls all of the above at once
+    io_handler::ZmqReactor reactor_;
+    
+    // Matching shards (not owned)
+    std::vector<MatchingEngineThread*> shards_;
+    
+    // Request whose shard ring was full, retried before taking more input
+    std::optional<PipelineRequest> stalled_;
+    
+    // Write-ahead journal (not owned; optional)
+    repository::OrderRepository* journal_;
+    bool sync_journal_;     // Every ack depends on its record: no record, no matching
+    
+    // Stage latencies: receive + parse, journal append, and writing replies to clients
+    std::shared_ptr<monitor::LatencyHistogram> decode_latency_;
+    std::shared_ptr<monitor::LatencyHistogram> journal_latency_;
+    std::shared_ptr<monitor::LatencyHistogram> send_latency_;
+    
+    // State
+    std::atomic<uint64_t> orders_received_;
+    
+    // Threading
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<bool> running_;
+};
+
+} // namespace marketsim::exchange::threads
@@ -0,0 +1,137 @@
+#include "order_response_thread.h"
+#include "io_handler/message_serializer.h"
+#include "monitor/monitor_helpers.h"
+#include <chrono>
+#include <iostream>
+
+namespace marketsim::exchange::threads {
+
+OrderResponseThread::OrderResponseThread(io_handler::IOContext& io_context, ResponseQueue& responses,
+                                         repository::OrderRepository* journal)
+    : responses_(responses)
+    , batch_(kBatchSize)
+    , sync_journal_(journal && journal->durability() == repository::DurabilityMode::SYNC ? journal : nullptr)
+    , push_socket_(io_context.get_context(), zmq::socket_type::push)
+    , serialize_latency_(monitor::StatusMonitor::instance().register_latency("serialize"))
+    , order_path_latency_(monitor::StatusMonitor::instance().register_latency("order_path"))
+    , responses_sent_(0)
+    , running_(false)
+{
+    push_socket_.set(zmq::sockopt::linger, 0);
+    push_socket_.connect(kResponseEndpoint);
+}
+
+OrderResponseThread::~OrderResponseThread() {
+    stop();
+    push_socket_.close();
+}
+
+void OrderResponseThread::start() {
+    if (running_) {
+        return;
+    }
+    
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&OrderResponseThread::run, this);
+}
+
+void OrderResponseThread::stop() {
+    running_ = false;
+    
+    // Wake up if blocked
+    responses_.stop();
+    
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+}
+
+void OrderResponseThread::run() {
+    monitor::MonitoredThread monitor("Exchange_Responder");
+    
+    while (running_) {
+        monitor.update_state(monitor::ThreadState::IDLE);
+        size_t count = responses_.pop_batch_for(batch_.data(), batch_.size(), std::chrono::milliseconds(100));
+        if (count == 0) {
+            continue;
+        }
+        
+        monitor.update_state(monitor::ThreadState::RUNNING);
+        for (size_t i = 0; i < count; ++i) {
+            send(batch_[i]);
+            monitor.increment_tasks();
+        }
+    }
+}
+
+void OrderResponseThread::send(PipelineResponse& response) {
+    // Frames: [channel][identity][delimited][payload]
+    // Serialized straight into the frame that travels to the ingest thread
+    zmq::message_t payload_frame;
+    try {
+        switch (response.channel) {
+            case ResponseChannel::ORDER: {
+                monitor::ScopedLatency timer(*serialize_latency_);
+                io_handler::MessageSerializer::serialize_to_frame(response.ack, payload_frame);
+                break;
+            }
+            case ResponseChannel::BATCH: {
+                monitor::ScopedLatency timer(*serialize_latency_);
+                io_handler::MessageSerializer::serialize_to_frame(response.ack_batch, payload_frame);
+                break;
+            }
+            case ResponseChannel::STATUS:
+                // Already serialized by the shard, off its status arena
+                payload_frame = std::move(response.status_payload);
+                break;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[RESPONDER] Serialization failed: " << e.what() << "\n";
+        return;
+    }
+    
+    // Write-ahead: the client hears nothing before its order is on disk
+    // (orders the journal refused were already rejected by the ingest thread)
+    if (sync_journal_ && response.journal_sequence != 0 && !await_durable(response.journal_sequence)) {
+        return;
+    }
+    
+    uint8_t channel = static_cast<uint8_t>(response.channel);
+    uint8_t delimited = response.envelope.delimited ? 1 : 0;
+    
+    try {
+        zmq::message_t channel_frame(&channel, sizeof(channel));
+        zmq::message_t identity_frame(response.envelope.identity.data(), response.envelope.identity.size());
+        zmq::message_t delimited_frame(&delimited, sizeof(delimited));
+        
+        push_socket_.send(channel_frame, zmq::send_flags::sndmore);
+        push_socket_.send(identity_frame, zmq::send_flags::sndmore);
+        push_socket_.send(delimited_frame, zmq::send_flags::sndmore);
+        push_socket_.send(payload_frame, zmq::send_flags::none);
+        responses_sent_++;
+        
+        if (response.channel != ResponseChannel::STATUS) {
+            order_path_latency_->record(std::chrono::steady_clock::now() - response.received_at);
+        }
+    } catch (const zmq::error_t& e) {
+        std::cerr << "[RESPONDER] Send failed: " << e.what() << "\n";
+    }
+}
+
+bool OrderResponseThread::await_durable(uint64_t sequence) {
+    bool reported = false;
+    while (!sync_journal_->wait_durable(sequence, kDurableWait)) {
+        if (!running_ || !sync_journal_->is_running()) {
+            std::cerr << "[RESPONDER] Shutting down before sequence " << sequence
+                      << " was durable; its ack is withheld\n";
+            return false;
+        }
+        if (!reported) {
+            std::cerr << "[RESPONDER] Journal flush stalled at sequence " << sequence << "; holding acks\n";
+            reported = true;
+        }
+    }
+    return true;
+}
+
+} // namespace marketsim::exchange::threads
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "pipeline_types.h"
+#include "exchange/repository/order_repository.h"
+#include "io_handler/io_context.h"
+#include "monitor/latency_histogram.h"
+#include <zmq.hpp>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace marketsim::exchange::threads {
+
+/**
+ * @brief Thread that serializes responses and hands them to the ingest thread
+ * 
+ * Consumes acks and status replies from all matching threads, serializes them
+ * off the matching path and pushes them over an inproc socket to the ingest
+ * thread, which owns the client-facing sockets and sends them out.
+ *
+ * With a SYNC journal, an order's ack is held until its journal record is
+ * flushed; one flush releases every ack waiting behind it. A stalled flush
+ * holds the acks for as long as it lasts - no success goes out early.
+ */
+class OrderResponseThread {
+public:
+    /**
+     * @brief Construct response thread
+     * @param io_context ZeroMQ context (shared with the ingest thread for inproc)
+     * @param responses Queue filled by the matching threads (not owned)
+     * @param journal Order journal whose flushes gate acks in SYNC mode (not owned; optional)
+     */
+    OrderResponseThread(io_handler::IOContext& io_context, ResponseQueue& responses,
+                        repository::OrderRepository* journal = nullptr);
+    
+    ~OrderResponseThread();
+    
+    /**
+     * @brief Start sending responses
+     */
+    void start();
+    
+    /**
+     * @brief Stop sending responses
+     */
+    void stop();
+    
+    /**
+     * @brief Check if thread is running
+     */
+    bool is_running() const { return running_; }
+    
+    /**
+     * @brief Get number of responses sent
+     */
+    uint64_t responses_sent() const { return responses_sent_; }
+    
+private:
+    // Responses taken off the ring per wakeup
+    static constexpr size_t kBatchSize = 64;
+    
+    // How long one durable wait lasts before a stalled flush is reported (and waited on again)
+    static constexpr std::chrono::milliseconds kDurableWait{1000};
+    
+    void run();
+    void send(PipelineResponse& response);
+    
+    // Block until sequence is durable; false if shutting down first (the ack is withheld)
+    bool await_durable(uint64_t sequence);
+    
+    // Shared queue (not owned by this thread)
+    ResponseQueue& responses_;
+    std::vector<PipelineResponse> batch_;
+    
+    // Set only when acks must wait for the journal (SYNC)
+    repository::OrderRepository* sync_journal_;
+    
+    // Inproc PUSH to the ingest thread
+    zmq::socket_t push_socket_;
+    
+    // Stage latencies: serialize, and wire-in to hand-back for orders/batches
+    std::shared_ptr<monitor::LatencyHistogram> serialize_latency_;
+    std::shared_ptr<monitor::LatencyHistogram> order_path_latency_;
+    
+    // State
+    std::atomic<uint64_t> responses_sent_;
+    
+    // Threading
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<bool> running_;
+};
+
+} // namespace marketsim::exchange::threads
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "io_handler/zmq_router.h"
+#include "common/concurrency/spsc_ring.h"
+#include "common/concurrency/mpsc_ring.h"
+#include "exchange/operations/book_delta_tracker.h"
+#include "exchange/operations/matching_engine.h"
+#include "exchange.pb.h"
+#include <zmq.hpp>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace marketsim::exchange::threads {
+
+/**
+ * @brief Which client socket a response goes back out on
+ */
+enum class ResponseChannel : uint8_t {
+    ORDER,    // ROUTER order gateway (async, addressed by envelope)
+    STATUS,   // REP status endpoint (lockstep, one outstanding request)
+    BATCH     // ROUTER batch gateway (OrderBatch in, OrderAckBatch out)
+};
+
+/**
+ * @brief Work item routed from the ingest thread to a matching thread
+ */
+struct PipelineRequest {
+    ResponseChannel channel = ResponseChannel::ORDER;
+    io_handler::RoutingEnvelope envelope;
+    Order order;                      // Set for ORDER
+    StatusRequest status_request;     // Set for STATUS
+    OrderBatch batch;                 // Set for BATCH
+    std::chrono::steady_clock::time_point received_at;  // Off the client socket (latency stages)
+    uint64_t journal_sequence = 0;    // Order journal record (0 = not journaled)
+};
+
+/**
+ * @brief Result handed from a matching thread to the response thread
+ */
+struct PipelineResponse {
+    ResponseChannel channel = ResponseChannel::ORDER;
+    io_handler::RoutingEnvelope envelope;
+    OrderAck ack;                                 // Set for ORDER
+    zmq::message_t status_payload;                // Set for STATUS (serialized on the shard)
+    OrderAckBatch ack_batch;                      // Set for BATCH
+    std::chrono::steady_clock::time_point received_at;  // Copied from the request
+    uint64_t journal_sequence = 0;                // Copied from the request
+};
+
+struct MarketDataEvent;
+
+// Market data thread -> one shard: spent events going back for reuse
+using MarketDataPool = common::concurrency::SpscRing<MarketDataEvent>;
+
+/**
+ * @brief Book changes and trades caused by one order (or batch), handed from a
+ * matching thread to the market data thread
+ *
+ * Events circulate: once published, the market data thread hands an event
+ * back through its `pool`, and the shard refills it, so the strings and
+ * vectors keep their capacity and neither thread allocates in steady state.
+ */
+struct MarketDataEvent {
+    std::string symbol;
+    uint64_t sequence = 0;                        // Per symbol, assigned by the owning shard
+    int64_t timestamp_us = 0;
+    double tick_size = 0;                         // Converts fill price ticks to prices
+    bool reset = false;                           // levels is the whole tracked depth (after a drop)
+    std::vector<operations::LevelDelta> levels;
+    std::vector<operations::Fill> trades;
+    MarketDataPool* pool = nullptr;               // Where the spent event goes (owning shard's)
+};
+
+// Shard that owns a symbol (ingest routing, and recovery at startup)
+inline size_t shard_for_symbol(const std::string& symbol, size_t shard_count) {
+    return std::hash<std::string>{}(symbol) % shard_count;
+}
+
+// Ingest -> one shard (single producer); all shards -> response thread
+using RequestQueue = common::concurrency::SpscRing<PipelineRequest>;
+using ResponseQueue = common::concurrency::MpscRing<PipelineResponse>;
+
+// All shards -> market data thread
+using MarketDataQueue = common::concurrency::MpscRing<MarketDataEvent>;
+
+// Inproc endpoint the response thread pushes serialized replies to
+inline constexpr const char* kResponseEndpoint = "inproc://exchange-responses";
+
+// Market data topics are <prefix><symbol>'\0'. ZeroMQ matches topics by prefix;
+// the terminator keeps "BOOK.AAPL" from also matching "BOOK.AAPLX" (and "."
+// would not do: symbols may contain one). Subscribe to the bare prefix for every symbol.
+inline constexpr const char* kBookTopicPrefix = "BOOK.";     // BookUpdate and BookSnapshot
+inline constexpr const char* kQuoteTopicPrefix = "QUOTE.";   // Conflated Quote
+
+inline std::string market_data_topic(const char* prefix, const std::string& symbol) {
+    std::string topic = prefix + symbol;
+    topic.push_back('\0');
+    return topic;
+}
+
+} // namespace marketsim::exchange::threads
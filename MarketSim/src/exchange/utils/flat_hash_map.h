@@ -0,0 +1,136 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+namespace marketsim::exchange::utils {
+
+/**
+ * @brief Open-addressing hash map (linear probing) in one flat array
+ *
+ * Unlike std::unordered_map there is no per-entry node allocation: once reserved,
+ * insert/erase never touch the allocator. Erase uses backward-shift deletion, so
+ * there are no tombstones and probe chains stay short. Load factor is kept <= 1/2.
+ * Key and Value must be cheap to copy (ids, pointers, string_views).
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlatHashMap {
+public:
+    explicit FlatHashMap(size_t expected = 16)
+        : size_(0)
+        , mask_(0)
+    {
+        reserve(expected);
+    }
+
+    // Make room for `count` entries without further allocation
+    void reserve(size_t count) {
+        size_t capacity = 16;
+        while (capacity < count * 2) {
+            capacity <<= 1;
+        }
+        if (capacity > slots_.size()) {
+            rehash(capacity);
+        }
+    }
+
+    Value* find(const Key& key) {
+        size_t i = probe(key);
+        return slots_[i].used ? &slots_[i].value : nullptr;
+    }
+
+    const Value* find(const Key& key) const {
+        size_t i = probe(key);
+        return slots_[i].used ? &slots_[i].value : nullptr;
+    }
+
+    // Returns true if the key was new
+    bool insert_or_assign(const Key& key, const Value& value) {
+        if ((size_ + 1) * 2 > slots_.size()) {
+            rehash(slots_.size() * 2);
+        }
+        size_t i = probe(key);
+        slots_[i].value = value;
+        if (slots_[i].used) {
+            return false;
+        }
+        slots_[i].key = key;
+        slots_[i].used = true;
+        ++size_;
+        return true;
+    }
+
+    bool erase(const Key& key) {
+        size_t i = probe(key);
+        if (!slots_[i].used) {
+            return false;
+        }
+        slots_[i].used = false;
+        --size_;
+
+        // Shift later members of the probe chain back into the hole
+        for (size_t j = (i + 1) & mask_; slots_[j].used; j = (j + 1) & mask_) {
+            size_t home = bucket(slots_[j].key);
+            bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+            if (stays) {
+                continue;
+            }
+            slots_[i] = slots_[j];
+            slots_[j].used = false;
+            i = j;
+        }
+        return true;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    struct Slot {
+        Key key{};
+        Value value{};
+        bool used = false;
+    };
+
+    size_t bucket(const Key& key) const {
+        // Finalizer mix so sequential ids spread over the table
+        uint64_t h = static_cast<uint64_t>(Hash{}(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return static_cast<size_t>(h) & mask_;
+    }
+
+    // Slot holding key, or the empty slot where it would go
+    size_t probe(const Key& key) const {
+        size_t i = bucket(key);
+        while (slots_[i].used && !(slots_[i].key == key)) {
+            i = (i + 1) & mask_;
+        }
+        return i;
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Slot> old;
+        old.swap(slots_);
+        slots_.resize(capacity);
+        mask_ = capacity - 1;
+        size_ = 0;
+        for (const Slot& slot : old) {
+            if (slot.used) {
+                size_t i = probe(slot.key);
+                slots_[i] = slot;
+                ++size_;
+            }
+        }
+    }
+
+    std::vector<Slot> slots_;
+    size_t size_;
+    size_t mask_;
+};
+
+} // namespace marketsim::exchange::utils
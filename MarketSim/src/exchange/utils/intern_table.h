@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <deque>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+namespace marketsim::exchange::utils {
+
+using InternId = uint32_t;
+
+/**
+ * @brief Maps strings (symbols, client ids) to dense integer ids and back
+ *
+ * Ids are handed out in first-seen order starting at 0, so they can index a vector.
+ * Lookups take a string_view and never allocate; only the first sighting of a name
+ * copies it. Not thread-safe - intern on the thread that owns the table.
+ */
+class InternTable {
+public:
+    static constexpr InternId npos = static_cast<InternId>(-1);
+
+    // Id for name, assigning the next id if it is new
+    InternId intern(std::string_view name) {
+        auto it = ids_.find(name);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+        InternId id = static_cast<InternId>(names_.size());
+        names_.emplace_back(name);
+        ids_.emplace(std::string_view(names_.back()), id);
+        return id;
+    }
+
+    // Id for name, npos if never interned
+    InternId find(std::string_view name) const {
+        auto it = ids_.find(name);
+        return it != ids_.end() ? it->second : npos;
+    }
+
+    const std::string& name(InternId id) const { return names_[id]; }
+
+    size_t size() const { return names_.size(); }
+
+private:
+    // deque keeps element addresses stable, so map keys can view into it
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, InternId> ids_;
+};
+
+} // namespace marketsim::exchange::utils
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <thread>
+#include <cstddef>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace marketsim::exchange::utils {
+
+/**
+ * @brief Pin the calling thread to one CPU (modulo the number of CPUs)
+ * @return true if pinned, false if unsupported or refused by the OS
+ */
+inline bool pin_current_thread(size_t cpu) {
+#ifdef __linux__
+    unsigned int cpus = std::thread::hardware_concurrency();
+    if (cpus == 0) {
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<int>(cpu % cpus), &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+} // namespace marketsim::exchange::utils
@@ -1,4 +1,5 @@
 #include "message_serializer.h"
+#include <climits>
 #include <stdexcept>
 
 namespace marketsim::io_handler {
@@ -17,6 +18,26 @@ bool MessageSerializer::deserialize(const std::string& data, google::protobuf::M
     return message.ParseFromString(data);
 }
 
+void MessageSerializer::serialize_to_frame(const google::protobuf::Message& message, zmq::message_t& frame) {
+    size_t size = message.ByteSizeLong();
+    frame.rebuild(size);
+    
+    // Sizes above INT_MAX are not representable in the array API
+    if (size > INT_MAX ||
+        !message.SerializeToArray(frame.data(), static_cast<int>(size))) {
+        std::string error_msg = "Failed to serialize protobuf message: ";
+        error_msg += std::string(message.GetTypeName());
+        throw std::runtime_error(error_msg);
+    }
+}
+
+bool MessageSerializer::deserialize_from_frame(const zmq::message_t& frame, google::protobuf::Message& message) {
+    if (frame.size() > INT_MAX) {
+        return false;
+    }
+    return message.ParseFromArray(frame.data(), static_cast<int>(frame.size()));
+}
+
 std::vector<uint8_t> MessageSerializer::serialize_to_bytes(const google::protobuf::Message& message) {
     std::string serialized = serialize(message);
     return std::vector<uint8_t>(serialized.begin(), serialized.end());
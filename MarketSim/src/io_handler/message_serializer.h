@@ -1,6 +1,7 @@
 #pragma once
 
 #include <google/protobuf/message.h>
+#include <zmq.hpp>
 #include <string>
 #include <vector>
 #include <optional>
@@ -28,6 +29,22 @@ public:
      */
     static bool deserialize(const std::string& data, google::protobuf::Message& message);
     
+    /**
+     * @brief Serialize straight into a ZMQ frame (sized once, no intermediate string)
+     * @param message The protobuf message to serialize
+     * @param frame Output frame, rebuilt to exactly the serialized size
+     * @throws std::runtime_error if serialization fails
+     */
+    static void serialize_to_frame(const google::protobuf::Message& message, zmq::message_t& frame);
+    
+    /**
+     * @brief Parse straight from a ZMQ frame (no copy into a string)
+     * @param frame Received frame
+     * @param message Output message to populate
+     * @return true if successful, false otherwise
+     */
+    static bool deserialize_from_frame(const zmq::message_t& frame, google::protobuf::Message& message);
+    
     /**
      * @brief Serialize to a vector of bytes (for ZMQ compatibility)
      * @param message The protobuf message to serialize
@@ -0,0 +1,32 @@
+#include "sequence_gap_detector.h"
+
+namespace marketsim::io_handler {
+
+SequenceGapDetector::Result SequenceGapDetector::check(const std::string& stream, uint64_t sequence) {
+    uint64_t& last = last_[stream];
+    
+    if (sequence <= last) {
+        stale_count_++;
+        return Result::STALE;
+    }
+    
+    Result result = Result::IN_ORDER;
+    if (sequence != last + 1) {
+        gap_count_++;
+        missed_count_ += sequence - last - 1;
+        result = Result::GAP;
+    }
+    last = sequence;
+    return result;
+}
+
+void SequenceGapDetector::reset(const std::string& stream, uint64_t sequence) {
+    last_[stream] = sequence;
+}
+
+uint64_t SequenceGapDetector::last(const std::string& stream) const {
+    auto it = last_.find(stream);
+    return it != last_.end() ? it->second : 0;
+}
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+namespace marketsim::io_handler {
+
+/**
+ * @brief Tracks per-stream sequence numbers and spots gaps and repeats
+ *
+ * A stream is any independently sequenced series (e.g. one symbol's book
+ * updates). Sequences start at 1, so the first message seen on a stream is a
+ * gap unless it is 1: a late joiner is told to recover straight away instead
+ * of waiting for the next periodic snapshot.
+ *
+ * Not thread-safe: owned by the receiving thread.
+ */
+class SequenceGapDetector {
+public:
+    enum class Result {
+        IN_ORDER,   // Exactly the next sequence
+        GAP,        // One or more sequences were skipped (stream now continues from this one)
+        STALE       // At or below the last one seen: duplicate, or already covered by a snapshot
+    };
+    
+    /**
+     * @brief Check a received sequence and advance the stream
+     */
+    Result check(const std::string& stream, uint64_t sequence);
+    
+    /**
+     * @brief Set the last sequence of a stream (e.g. the one a snapshot is current to)
+     */
+    void reset(const std::string& stream, uint64_t sequence);
+    
+    /**
+     * @brief Last sequence seen on a stream (0 if none)
+     */
+    uint64_t last(const std::string& stream) const;
+    
+    /**
+     * @brief Number of gaps detected
+     */
+    uint64_t gap_count() const { return gap_count_; }
+    
+    /**
+     * @brief Total sequences skipped over all gaps
+     */
+    uint64_t missed_count() const { return missed_count_; }
+    
+    /**
+     * @brief Number of stale messages seen
+     */
+    uint64_t stale_count() const { return stale_count_; }
+    
+private:
+    std::unordered_map<std::string, uint64_t> last_;
+    uint64_t gap_count_ = 0;
+    uint64_t missed_count_ = 0;
+    uint64_t stale_count_ = 0;
+};
+
+}
@@ -0,0 +1,157 @@
+#include "zmq_async_requester.h"
+
+namespace marketsim::io_handler {
+
+ZmqAsyncRequester::ZmqAsyncRequester(IOContext& context, const std::string& name,
+                                     const std::string& endpoint, size_t max_in_flight)
+    : socket_(context.get_context(), zmq::socket_type::dealer)
+    , endpoint_(endpoint)
+    , connected_(false)
+    , max_in_flight_(max_in_flight > 0 ? max_in_flight : 1)
+    , monitor_(std::make_unique<monitor::MonitoredSocket>(
+        name,
+        monitor::SocketType::DEALER,
+        endpoint
+    ))
+{
+    in_flight_.reserve(max_in_flight_);
+    monitor_->update_state(monitor::SocketState::DISCONNECTED);
+}
+
+ZmqAsyncRequester::~ZmqAsyncRequester() {
+    close();
+}
+
+void ZmqAsyncRequester::connect() {
+    try {
+        // Don't hang on shutdown with unsent requests
+        socket_.set(zmq::sockopt::linger, 0);
+        socket_.connect(endpoint_);
+        connected_ = true;
+        monitor_->update_state(monitor::SocketState::CONNECTED);
+    } catch (const zmq::error_t& e) {
+        monitor_->record_error(std::string("Connect failed: ") + e.what());
+        monitor_->update_state(monitor::SocketState::ERROR);
+        throw;
+    }
+}
+
+bool ZmqAsyncRequester::send(const std::string& correlation_id, const google::protobuf::Message& request) {
+    if (!connected_) {
+        monitor_->record_error("Cannot send request: socket not connected");
+        return false;
+    }
+    if (!can_send() || in_flight_.count(correlation_id) != 0) {
+        return false;
+    }
+
+    try {
+        zmq::message_t req_msg;
+        MessageSerializer::serialize_to_frame(request, req_msg);
+        size_t req_size = req_msg.size();
+
+        // No delimiter frame: the ROUTER side replies the same way
+        auto send_result = socket_.send(req_msg, zmq::send_flags::dontwait);
+        if (!send_result) {
+            monitor_->record_error("Failed to send request (high-water mark)");
+            return false;
+        }
+        monitor_->record_send(req_size);
+        in_flight_.emplace(correlation_id, std::chrono::steady_clock::now());
+        return true;
+    } catch (const zmq::error_t& e) {
+        monitor_->record_error(std::string("Send request failed: ") + e.what());
+        monitor_->update_state(monitor::SocketState::ERROR);
+        return false;
+    } catch (const std::exception& e) {
+        monitor_->record_error(std::string("Send request failed: ") + e.what());
+        return false;
+    }
+}
+
+bool ZmqAsyncRequester::receive(google::protobuf::Message& response, int timeout_ms) {
+    if (!connected_) {
+        monitor_->record_error("Cannot receive: socket not connected");
+        return false;
+    }
+
+    try {
+        zmq::message_t resp_msg;
+        zmq::recv_result_t recv_result;
+        if (timeout_ms == 0) {
+            recv_result = socket_.recv(resp_msg, zmq::recv_flags::dontwait);
+        } else {
+            socket_.set(zmq::sockopt::rcvtimeo, timeout_ms);
+            recv_result = socket_.recv(resp_msg, zmq::recv_flags::none);
+        }
+
+        if (!recv_result) {
+            return false;
+        }
+
+        // Tolerate a REQ-style empty delimiter in front of the payload
+        if (resp_msg.size() == 0 && resp_msg.more()) {
+            socket_.recv(resp_msg, zmq::recv_flags::none);
+        }
+
+        if (!MessageSerializer::deserialize_from_frame(resp_msg, response)) {
+            monitor_->record_error("Response deserialization failed");
+            return false;
+        }
+        monitor_->record_receive(resp_msg.size());
+        return true;
+    } catch (const zmq::error_t& e) {
+        if (e.num() == EAGAIN) {
+            return false;
+        }
+        monitor_->record_error(std::string("Receive response failed: ") + e.what());
+        monitor_->update_state(monitor::SocketState::ERROR);
+        return false;
+    }
+}
+
+bool ZmqAsyncRequester::complete(const std::string& correlation_id, std::chrono::nanoseconds* round_trip) {
+    auto it = in_flight_.find(correlation_id);
+    if (it == in_flight_.end()) {
+        return false;
+    }
+
+    if (round_trip) {
+        *round_trip = std::chrono::steady_clock::now() - it->second;
+    }
+    in_flight_.erase(it);
+    return true;
+}
+
+size_t ZmqAsyncRequester::expire(std::chrono::milliseconds max_age) {
+    auto cutoff = std::chrono::steady_clock::now() - max_age;
+    size_t expired = 0;
+    for (auto it = in_flight_.begin(); it != in_flight_.end();) {
+        if (it->second < cutoff) {
+            it = in_flight_.erase(it);
+            ++expired;
+        } else {
+            ++it;
+        }
+    }
+
+    if (expired > 0) {
+        monitor_->record_error("Requests timed out: " + std::to_string(expired));
+    }
+    return expired;
+}
+
+void ZmqAsyncRequester::close() {
+    if (connected_) {
+        socket_.close();
+        connected_ = false;
+        in_flight_.clear();
+        monitor_->update_state(monitor::SocketState::DISCONNECTED);
+    }
+}
+
+bool ZmqAsyncRequester::is_connected() const {
+    return connected_;
+}
+
+}
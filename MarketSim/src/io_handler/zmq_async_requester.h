@@ -0,0 +1,113 @@
+#pragma once
+
+#include "io_context.h"
+#include "message_serializer.h"
+#include "monitor/monitor_helpers.h"
+#include "monitor/socket_info.h"
+#include <zmq.hpp>
+#include <chrono>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <google/protobuf/message.h>
+
+namespace marketsim::io_handler {
+
+/**
+ * @brief ZeroMQ asynchronous requester (DEALER socket) with monitoring
+ *
+ * Client side of a pipelined request/response channel against a ROUTER
+ * server. Unlike ZmqRequester, sending does not wait for the reply: up to
+ * max_in_flight requests can be outstanding, each tracked by a caller-chosen
+ * correlation id (e.g. the order id) until complete() is called for it.
+ * Replies may arrive in any order. Owned by a single thread.
+ */
+class ZmqAsyncRequester {
+public:
+    /**
+     * @brief Construct an async requester
+     * @param context IOContext for this component
+     * @param name Unique name for monitoring
+     * @param endpoint Endpoint to connect (e.g., "tcp://localhost:5555")
+     * @param max_in_flight Window size: sends are refused once this many are outstanding
+     */
+    ZmqAsyncRequester(IOContext& context, const std::string& name, const std::string& endpoint,
+                      size_t max_in_flight = 64);
+
+    ~ZmqAsyncRequester();
+
+    /**
+     * @brief Connect to the router
+     * @throws zmq::error_t on failure
+     */
+    void connect();
+
+    /**
+     * @brief Send a request without waiting for the reply
+     * @param correlation_id Id the reply will be matched on (must be unique while in flight)
+     * @param request The request message
+     * @return false if the window is full, the id is already in flight, or on error
+     */
+    bool send(const std::string& correlation_id, const google::protobuf::Message& request);
+
+    /**
+     * @brief Receive the next reply
+     * @param response The response message to populate
+     * @param timeout_ms Timeout in milliseconds (-1 = block, 0 = non-blocking)
+     * @return true if a reply was received
+     */
+    bool receive(google::protobuf::Message& response, int timeout_ms);
+
+    /**
+     * @brief Retire an in-flight request once its reply has been matched
+     * @param correlation_id Id passed to send()
+     * @param round_trip Optional; set to the time since send()
+     * @return false if the id was not in flight (late or unknown reply)
+     */
+    bool complete(const std::string& correlation_id,
+                  std::chrono::nanoseconds* round_trip = nullptr);
+
+    /**
+     * @brief Give up on requests outstanding for longer than max_age
+     * @return Number of requests dropped from the window
+     */
+    size_t expire(std::chrono::milliseconds max_age);
+
+    /**
+     * @brief Number of requests awaiting a reply
+     */
+    size_t in_flight() const { return in_flight_.size(); }
+
+    /**
+     * @brief Whether the window has room for another request
+     */
+    bool can_send() const { return in_flight_.size() < max_in_flight_; }
+
+    /**
+     * @brief Underlying socket (for polling)
+     */
+    zmq::socket_t& socket() { return socket_; }
+
+    /**
+     * @brief Close the socket (outstanding requests are forgotten)
+     */
+    void close();
+
+    /**
+     * @brief Check if socket is connected
+     */
+    bool is_connected() const;
+
+private:
+    zmq::socket_t socket_;
+    std::string endpoint_;
+    bool connected_;
+    size_t max_in_flight_;
+
+    // Correlation id -> send time
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> in_flight_;
+
+    std::unique_ptr<monitor::MonitoredSocket> monitor_;
+};
+
+}
@@ -39,12 +39,13 @@ bool ZmqPublisher::publish(const google::protobuf::Message& message) {
     }
     
     try {
-        std::string serialized = MessageSerializer::serialize(message);
-        zmq::message_t zmq_msg(serialized.data(), serialized.size());
+        zmq::message_t zmq_msg;
+        MessageSerializer::serialize_to_frame(message, zmq_msg);
+        size_t size = zmq_msg.size();
         
         auto result = socket_.send(zmq_msg, zmq::send_flags::none);
         if (result) {
-            monitor_->record_send(serialized.size());
+            monitor_->record_send(size);
             return true;
         } else {
             monitor_->record_error("Send failed: no result");
@@ -67,6 +68,11 @@ bool ZmqPublisher::publish_with_topic(const std::string& topic, const google::pr
     }
     
     try {
+        // Serialize first so a failure can't leave a dangling topic frame
+        zmq::message_t data_msg;
+        MessageSerializer::serialize_to_frame(message, data_msg);
+        size_t size = data_msg.size();
+        
         // Send topic as first frame
         zmq::message_t topic_msg(topic.data(), topic.size());
         auto result = socket_.send(topic_msg, zmq::send_flags::sndmore);
@@ -77,12 +83,9 @@ bool ZmqPublisher::publish_with_topic(const std::string& topic, const google::pr
         }
         
         // Send message as second frame
-        std::string serialized = MessageSerializer::serialize(message);
-        zmq::message_t data_msg(serialized.data(), serialized.size());
-        
         result = socket_.send(data_msg, zmq::send_flags::none);
         if (result) {
-            monitor_->record_send(topic.size() + serialized.size());
+            monitor_->record_send(topic.size() + size);
             return true;
         } else {
             monitor_->record_error("Failed to send data frame");
@@ -0,0 +1,50 @@
+#include "zmq_reactor.h"
+
+namespace marketsim::io_handler {
+
+void ZmqReactor::add(zmq::socket_t& socket, Handler on_readable, Guard enabled) {
+    entries_.push_back(Entry{ &socket, std::move(on_readable), std::move(enabled) });
+}
+
+int ZmqReactor::wait(std::chrono::milliseconds timeout) {
+    items_.clear();
+    active_.clear();
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        const Entry& entry = entries_[i];
+        if (entry.enabled && !entry.enabled()) {
+            continue;
+        }
+        items_.push_back({ entry.socket->handle(), 0, ZMQ_POLLIN, 0 });
+        active_.push_back(i);
+    }
+
+    try {
+        return zmq::poll(items_.data(), items_.size(), timeout);
+    } catch (const zmq::error_t& e) {
+        if (e.num() == EINTR) {
+            return 0;
+        }
+        throw;
+    }
+}
+
+int ZmqReactor::dispatch() {
+    int handled = 0;
+    for (size_t i = 0; i < items_.size(); ++i) {
+        if (items_[i].revents & ZMQ_POLLIN) {
+            items_[i].revents = 0;
+            entries_[active_[i]].on_readable();
+            ++handled;
+        }
+    }
+    return handled;
+}
+
+int ZmqReactor::poll_once(std::chrono::milliseconds timeout) {
+    if (wait(timeout) <= 0) {
+        return 0;
+    }
+    return dispatch();
+}
+
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <zmq.hpp>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace marketsim::io_handler {
+
+/**
+ * @brief Single-threaded zmq_poll event loop over any number of sockets
+ *
+ * Components register a socket and a callback; one poll waits on all of them
+ * and every socket that became readable is dispatched straight away, so one
+ * idle socket never delays another. An optional guard takes a socket out of
+ * the poll set while it must not be read (e.g. a REP socket with a reply
+ * still pending). Handlers run in registration order, so register the most
+ * latency-sensitive socket first.
+ *
+ * Not thread-safe: register, wait and dispatch from the owning thread.
+ */
+class ZmqReactor {
+public:
+    using Handler = std::function<void()>;
+    using Guard = std::function<bool()>;
+
+    /**
+     * @brief Register a socket
+     * @param socket Socket to watch for input (must outlive the reactor)
+     * @param on_readable Called when the socket has a message
+     * @param enabled Optional; socket is only polled while this returns true
+     */
+    void add(zmq::socket_t& socket, Handler on_readable, Guard enabled = {});
+
+    /**
+     * @brief Wait until a registered socket is readable
+     * @param timeout Longest time to block (0 = just check)
+     * @return Number of readable sockets (0 on timeout or interrupt)
+     * @throws zmq::error_t on poll failure other than EINTR
+     */
+    int wait(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Run the handlers of the sockets found readable by the last wait()
+     * @return Number of handlers run
+     */
+    int dispatch();
+
+    /**
+     * @brief wait() then dispatch()
+     */
+    int poll_once(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Number of registered sockets
+     */
+    size_t size() const { return entries_.size(); }
+
+private:
+    struct Entry {
+        zmq::socket_t* socket;
+        Handler on_readable;
+        Guard enabled;
+    };
+
+    std::vector<Entry> entries_;
+
+    // Rebuilt by each wait(); active_[i] is the entry behind items_[i]
+    std::vector<zmq::pollitem_t> items_;
+    std::vector<size_t> active_;
+};
+
+}
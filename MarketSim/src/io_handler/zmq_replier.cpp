@@ -47,19 +47,19 @@ bool ZmqReplier::reply(google::protobuf::Message& request, const google::protobu
             return false;
         }
         
-        std::string req_data(static_cast<char*>(req_msg.data()), req_msg.size());
-        if (!MessageSerializer::deserialize(req_data, request)) {
+        if (!MessageSerializer::deserialize_from_frame(req_msg, request)) {
             monitor_->record_error("Request deserialization failed");
             return false;
         }
         monitor_->record_receive(req_msg.size());
         
-        std::string serialized_resp = MessageSerializer::serialize(response);
-        zmq::message_t resp_msg(serialized_resp.data(), serialized_resp.size());
+        zmq::message_t resp_msg;
+        MessageSerializer::serialize_to_frame(response, resp_msg);
+        size_t resp_size = resp_msg.size();
         
         auto send_result = socket_.send(resp_msg, zmq::send_flags::none);
         if (send_result) {
-            monitor_->record_send(serialized_resp.size());
+            monitor_->record_send(resp_size);
             return true;
         } else {
             monitor_->record_error("Failed to send response");
@@ -99,8 +99,7 @@ bool ZmqReplier::receive_request(google::protobuf::Message& request, int timeout
         }
         
         if (recv_result) {
-            std::string req_data(static_cast<char*>(req_msg.data()), req_msg.size());
-            if (MessageSerializer::deserialize(req_data, request)) {
+            if (MessageSerializer::deserialize_from_frame(req_msg, request)) {
                 monitor_->record_receive(req_msg.size());
                 waiting_for_response_ = true;
                 return true;
@@ -122,6 +121,17 @@ bool ZmqReplier::receive_request(google::protobuf::Message& request, int timeout
 }
 
 bool ZmqReplier::send_response(const google::protobuf::Message& response) {
+    try {
+        zmq::message_t resp_msg;
+        MessageSerializer::serialize_to_frame(response, resp_msg);
+        return send_frame(resp_msg);
+    } catch (const std::exception& e) {
+        monitor_->record_error(std::string("Send response failed: ") + e.what());
+        return false;
+    }
+}
+
+bool ZmqReplier::send_frame(zmq::message_t& payload) {
     if (!bound_) {
         monitor_->record_error("Cannot send response: socket not bound");
         return false;
@@ -133,12 +143,10 @@ bool ZmqReplier::send_response(const google::protobuf::Message& response) {
     }
     
     try {
-        std::string serialized_resp = MessageSerializer::serialize(response);
-        zmq::message_t resp_msg(serialized_resp.data(), serialized_resp.size());
-        
-        auto send_result = socket_.send(resp_msg, zmq::send_flags::none);
+        size_t payload_size = payload.size();
+        auto send_result = socket_.send(payload, zmq::send_flags::none);
         if (send_result) {
-            monitor_->record_send(serialized_resp.size());
+            monitor_->record_send(payload_size);
             waiting_for_response_ = false;
             return true;
         } else {
@@ -149,9 +157,6 @@ bool ZmqReplier::send_response(const google::protobuf::Message& response) {
         monitor_->record_error(std::string("Send response failed: ") + e.what());
         monitor_->update_state(monitor::SocketState::ERROR);
         return false;
-    } catch (const std::exception& e) {
-        monitor_->record_error(std::string("Send response failed: ") + e.what());
-        return false;
     }
 }
 
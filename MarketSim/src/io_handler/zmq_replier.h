@@ -58,6 +58,23 @@ public:
      */
     bool send_response(const google::protobuf::Message& response);
     
+    /**
+     * @brief Send an already serialized response frame without copying it
+     * (must be called after receive_request)
+     * @param payload Frame to send; left empty on success (ownership passes to ZMQ)
+     */
+    bool send_frame(zmq::message_t& payload);
+    
+    /**
+     * @brief True between receive_request and the matching send
+     */
+    bool awaiting_response() const { return waiting_for_response_; }
+    
+    /**
+     * @brief Underlying socket (for polling)
+     */
+    zmq::socket_t& socket() { return socket_; }
+    
     /**
      * @brief Close the socket
      */
@@ -6,6 +6,7 @@ ZmqRequester::ZmqRequester(IOContext& context, const std::string& name, const st
     : socket_(context.get_context(), zmq::socket_type::req)
     , endpoint_(endpoint)
     , connected_(false)
+    , timeout_ms_(-1)
     , monitor_(std::make_unique<monitor::MonitoredSocket>(
         name,
         monitor::SocketType::REQ,
@@ -31,6 +32,18 @@ void ZmqRequester::connect() {
     }
 }
 
+void ZmqRequester::set_relaxed(int timeout_ms) {
+    try {
+        socket_.set(zmq::sockopt::req_relaxed, 1);
+        socket_.set(zmq::sockopt::req_correlate, 1);
+        socket_.set(zmq::sockopt::rcvtimeo, timeout_ms);
+        timeout_ms_ = timeout_ms;
+    } catch (const zmq::error_t& e) {
+        monitor_->record_error(std::string("Set relaxed failed: ") + e.what());
+        throw;
+    }
+}
+
 bool ZmqRequester::request(const google::protobuf::Message& request, google::protobuf::Message& response) {
     if (!connected_) {
         monitor_->record_error("Cannot send request: socket not connected");
@@ -38,22 +51,22 @@ bool ZmqRequester::request(const google::protobuf::Message& request, google::pro
     }
     
     try {
-        std::string serialized_req = MessageSerializer::serialize(request);
-        zmq::message_t req_msg(serialized_req.data(), serialized_req.size());
+        zmq::message_t req_msg;
+        MessageSerializer::serialize_to_frame(request, req_msg);
+        size_t req_size = req_msg.size();
         
         auto send_result = socket_.send(req_msg, zmq::send_flags::none);
         if (!send_result) {
             monitor_->record_error("Failed to send request");
             return false;
         }
-        monitor_->record_send(serialized_req.size());
+        monitor_->record_send(req_size);
         
         zmq::message_t resp_msg;
         auto recv_result = socket_.recv(resp_msg, zmq::recv_flags::none);
         
         if (recv_result) {
-            std::string data(static_cast<char*>(resp_msg.data()), resp_msg.size());
-            if (MessageSerializer::deserialize(data, response)) {
+            if (MessageSerializer::deserialize_from_frame(resp_msg, response)) {
                 monitor_->record_receive(resp_msg.size());
                 return true;
             } else {
@@ -85,25 +98,25 @@ bool ZmqRequester::request_with_timeout(const google::protobuf::Message& request
     try {
         socket_.set(zmq::sockopt::rcvtimeo, timeout_ms);
         
-        std::string serialized_req = MessageSerializer::serialize(request);
-        zmq::message_t req_msg(serialized_req.data(), serialized_req.size());
+        zmq::message_t req_msg;
+        MessageSerializer::serialize_to_frame(request, req_msg);
+        size_t req_size = req_msg.size();
         
         auto send_result = socket_.send(req_msg, zmq::send_flags::none);
         if (!send_result) {
             monitor_->record_error("Failed to send request");
-            socket_.set(zmq::sockopt::rcvtimeo, -1);
+            socket_.set(zmq::sockopt::rcvtimeo, timeout_ms_);
             return false;
         }
-        monitor_->record_send(serialized_req.size());
+        monitor_->record_send(req_size);
         
         zmq::message_t resp_msg;
         auto recv_result = socket_.recv(resp_msg, zmq::recv_flags::none);
         
-        socket_.set(zmq::sockopt::rcvtimeo, -1);
+        socket_.set(zmq::sockopt::rcvtimeo, timeout_ms_);
         
         if (recv_result) {
-            std::string data(static_cast<char*>(resp_msg.data()), resp_msg.size());
-            if (MessageSerializer::deserialize(data, response)) {
+            if (MessageSerializer::deserialize_from_frame(resp_msg, response)) {
                 monitor_->record_receive(resp_msg.size());
                 return true;
             } else {
@@ -36,10 +36,22 @@ public:
     void connect();
     
     /**
-     * @brief Send a request and wait for response (blocking)
+     * @brief Let the socket carry on after a request goes unanswered
+     *
+     * A plain REQ socket that timed out waiting for a reply refuses to send
+     * again (EFSM). This sets ZMQ_REQ_RELAXED, so the next request goes out
+     * anyway, and ZMQ_REQ_CORRELATE, so a late reply to the abandoned one is
+     * discarded instead of being taken for the new reply.
+     * @param timeout_ms Receive timeout for request() too (-1 = wait forever)
+     * @throws zmq::error_t on failure
+     */
+    void set_relaxed(int timeout_ms = -1);
+    
+    /**
+     * @brief Send a request and wait for response (blocking, unless set_relaxed gave a timeout)
      * @param request The request message
      * @param response The response message to populate
-     * @return true if successful, false on error
+     * @return true if successful, false on error or timeout
      */
     bool request(const google::protobuf::Message& request, google::protobuf::Message& response);
     
@@ -68,6 +80,7 @@ private:
     zmq::socket_t socket_;
     std::string endpoint_;
     bool connected_;
+    int timeout_ms_;    // Receive timeout outside request_with_timeout (-1 = none)
     std::unique_ptr<monitor::MonitoredSocket> monitor_;
 };
 
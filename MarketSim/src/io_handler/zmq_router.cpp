@@ -0,0 +1,148 @@
+#include "zmq_router.h"
+
+namespace marketsim::io_handler {
+
+ZmqRouter::ZmqRouter(IOContext& context, const std::string& name, const std::string& endpoint)
+    : socket_(context.get_context(), zmq::socket_type::router)
+    , endpoint_(endpoint)
+    , bound_(false)
+    , monitor_(std::make_unique<monitor::MonitoredSocket>(
+        name,
+        monitor::SocketType::ROUTER,
+        endpoint
+    ))
+{
+    monitor_->update_state(monitor::SocketState::DISCONNECTED);
+}
+
+ZmqRouter::~ZmqRouter() {
+    close();
+}
+
+void ZmqRouter::bind() {
+    try {
+        socket_.bind(endpoint_);
+        bound_ = true;
+        monitor_->update_state(monitor::SocketState::LISTENING);
+    } catch (const zmq::error_t& e) {
+        monitor_->record_error(std::string("Bind failed: ") + e.what());
+        monitor_->update_state(monitor::SocketState::ERROR);
+        throw;
+    }
+}
+
+bool ZmqRouter::receive(RoutingEnvelope& envelope, google::protobuf::Message& request, int timeout_ms) {
+    if (!bound_) {
+        monitor_->record_error("Cannot receive: socket not bound");
+        return false;
+    }
+
+    try {
+        zmq::message_t identity;
+        zmq::recv_result_t recv_result;
+        if (timeout_ms == 0) {
+            recv_result = socket_.recv(identity, zmq::recv_flags::dontwait);
+        } else {
+            socket_.set(zmq::sockopt::rcvtimeo, timeout_ms);
+            recv_result = socket_.recv(identity, zmq::recv_flags::none);
+        }
+
+        if (!recv_result) {
+            return false;
+        }
+
+        // Remaining frames of a multipart message are already queued
+        envelope.identity.assign(static_cast<const char*>(identity.data()), identity.size());
+        envelope.delimited = false;
+
+        zmq::message_t frame;
+        if (!identity.more() || !socket_.recv(frame, zmq::recv_flags::none)) {
+            monitor_->record_error("Malformed request: missing payload");
+            return false;
+        }
+        if (frame.size() == 0 && frame.more()) {
+            envelope.delimited = true;
+            socket_.recv(frame, zmq::recv_flags::none);
+        }
+
+        // Drop any unexpected trailing frames
+        bool more = frame.more();
+        while (more) {
+            zmq::message_t extra;
+            socket_.recv(extra, zmq::recv_flags::none);
+            more = extra.more();
+        }
+
+        if (!MessageSerializer::deserialize_from_frame(frame, request)) {
+            monitor_->record_error("Request deserialization failed");
+            return false;
+        }
+        monitor_->record_receive(frame.size());
+        return true;
+    } catch (const zmq::error_t& e) {
+        if (e.num() == EAGAIN) {
+            return false;
+        }
+        monitor_->record_error(std::string("Receive request failed: ") + e.what());
+        monitor_->update_state(monitor::SocketState::ERROR);
+        return false;
+    }
+}
+
+bool ZmqRouter::send(const RoutingEnvelope& envelope, const google::protobuf::Message& response) {
+    try {
+        zmq::message_t resp_msg;
+        MessageSerializer::serialize_to_frame(response, resp_msg);
+        return send_frame(envelope, resp_msg);
+    } catch (const std::exception& e) {
+        monitor_->record_error(std::string("Send response failed: ") + e.what());
+        return false;
+    }
+}
+
+bool ZmqRouter::send_frame(const RoutingEnvelope& envelope, zmq::message_t& payload) {
+    if (!bound_) {
+        monitor_->record_error("Cannot send response: socket not bound");
+        return false;
+    }
+
+    try {
+        zmq::message_t identity(envelope.identity.data(), envelope.identity.size());
+        if (!socket_.send(identity, zmq::send_flags::sndmore)) {
+            monitor_->record_error("Failed to send routing frame");
+            return false;
+        }
+
+        if (envelope.delimited) {
+            zmq::message_t delimiter;
+            socket_.send(delimiter, zmq::send_flags::sndmore);
+        }
+
+        size_t payload_size = payload.size();
+        auto send_result = socket_.send(payload, zmq::send_flags::none);
+        if (send_result) {
+            monitor_->record_send(payload_size);
+            return true;
+        } else {
+            monitor_->record_error("Failed to send response");
+            return false;
+        }
+    } catch (const zmq::error_t& e) {
+        monitor_->record_error(std::string("Send response failed: ") + e.what());
+        return false;
+    }
+}
+
+void ZmqRouter::close() {
+    if (bound_) {
+        socket_.close();
+        bound_ = false;
+        monitor_->update_state(monitor::SocketState::DISCONNECTED);
+    }
+}
+
+bool ZmqRouter::is_bound() const {
+    return bound_;
+}
+
+}
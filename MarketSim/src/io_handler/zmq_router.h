@@ -0,0 +1,93 @@
+#pragma once
+
+#include "io_context.h"
+#include "message_serializer.h"
+#include "monitor/monitor_helpers.h"
+#include "monitor/socket_info.h"
+#include <zmq.hpp>
+#include <string>
+#include <memory>
+#include <google/protobuf/message.h>
+
+namespace marketsim::io_handler {
+
+/**
+ * @brief Return address of a message received on a ROUTER socket
+ *
+ * REQ peers put an empty delimiter frame between their identity and the
+ * payload; DEALER peers may not. The reply has to mirror whichever was used.
+ */
+struct RoutingEnvelope {
+    std::string identity;
+    bool delimited = false;
+};
+
+/**
+ * @brief ZeroMQ Router (ROUTER socket) with monitoring
+ *
+ * Server side of an asynchronous request/response channel: any number of
+ * requests can be received before the replies are sent, in any order.
+ * Works with both REQ and DEALER clients. Owned by a single thread.
+ */
+class ZmqRouter {
+public:
+    /**
+     * @brief Construct a router
+     * @param context IOContext for this component
+     * @param name Unique name for monitoring
+     * @param endpoint Endpoint to bind (e.g., "tcp://*:5555")
+     */
+    ZmqRouter(IOContext& context, const std::string& name, const std::string& endpoint);
+
+    ~ZmqRouter();
+
+    /**
+     * @brief Bind the socket to the endpoint
+     * @throws zmq::error_t on failure
+     */
+    void bind();
+
+    /**
+     * @brief Receive a request with its return address
+     * @param envelope Populated with the sender's routing info
+     * @param request The request message to populate
+     * @param timeout_ms Timeout in milliseconds (-1 = block, 0 = non-blocking)
+     * @return true if request received, false on timeout or error
+     */
+    bool receive(RoutingEnvelope& envelope, google::protobuf::Message& request, int timeout_ms = -1);
+
+    /**
+     * @brief Send a response to the peer identified by envelope
+     * @return true if successful, false on error (e.g. peer gone)
+     */
+    bool send(const RoutingEnvelope& envelope, const google::protobuf::Message& response);
+
+    /**
+     * @brief Send an already serialized response frame without copying it
+     * @param payload Frame to send; left empty on success (ownership passes to ZMQ)
+     */
+    bool send_frame(const RoutingEnvelope& envelope, zmq::message_t& payload);
+
+    /**
+     * @brief Underlying socket (for polling)
+     */
+    zmq::socket_t& socket() { return socket_; }
+
+    /**
+     * @brief Close the socket
+     */
+    void close();
+
+    /**
+     * @brief Check if socket is bound
+     */
+    bool is_bound() const;
+
+private:
+    zmq::socket_t socket_;
+    std::string endpoint_;
+    bool bound_;
+    std::unique_ptr<monitor::MonitoredSocket> monitor_;
+};
+
+}
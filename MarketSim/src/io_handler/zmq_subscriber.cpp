@@ -1,9 +1,13 @@
 #include "zmq_subscriber.h"
+#include <algorithm>
+#include <chrono>
 
 namespace marketsim::io_handler {
 
 ZmqSubscriber::ZmqSubscriber(IOContext& context, const std::string& name, const std::string& endpoint)
-    : socket_(context.get_context(), zmq::socket_type::sub)
+    : context_(context)
+    , name_(name)
+    , socket_(context.get_context(), zmq::socket_type::sub)
     , endpoint_(endpoint)
     , connected_(false)
     , monitor_(std::make_unique<monitor::MonitoredSocket>(
@@ -56,21 +60,23 @@ bool ZmqSubscriber::receive(google::protobuf::Message& message) {
     }
     
     try {
-        zmq::message_t zmq_msg;
-        auto result = socket_.recv(zmq_msg, zmq::recv_flags::none);
-        
-        if (result) {
-            std::string data(static_cast<char*>(zmq_msg.data()), zmq_msg.size());
-            if (MessageSerializer::deserialize(data, message)) {
-                monitor_->record_receive(zmq_msg.size());
-                return true;
-            } else {
+        // Stale messages are dropped here; wait on for the next one
+        while (true) {
+            zmq::message_t zmq_msg;
+            auto result = socket_.recv(zmq_msg, zmq::recv_flags::none);
+            
+            if (!result) {
+                monitor_->record_error("Receive failed: no result");
+                return false;
+            }
+            if (!MessageSerializer::deserialize_from_frame(zmq_msg, message)) {
                 monitor_->record_error("Deserialization failed");
                 return false;
             }
-        } else {
-            monitor_->record_error("Receive failed: no result");
-            return false;
+            monitor_->record_receive(zmq_msg.size());
+            if (accept_sequence(message)) {
+                return true;
+            }
         }
     } catch (const zmq::error_t& e) {
         monitor_->record_error(std::string("Receive failed: ") + e.what());
@@ -86,24 +92,34 @@ bool ZmqSubscriber::receive_with_timeout(google::protobuf::Message& message, int
     }
     
     try {
-        socket_.set(zmq::sockopt::rcvtimeo, timeout_ms);
-        
-        zmq::message_t zmq_msg;
-        auto result = socket_.recv(zmq_msg, zmq::recv_flags::none);
-        
-        socket_.set(zmq::sockopt::rcvtimeo, -1);
-        
-        if (result) {
-            std::string data(static_cast<char*>(zmq_msg.data()), zmq_msg.size());
-            if (MessageSerializer::deserialize(data, message)) {
-                monitor_->record_receive(zmq_msg.size());
-                return true;
-            } else {
+        // Stale messages are dropped here; wait on for the next one, within the same timeout
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        int remaining_ms = timeout_ms;
+        while (true) {
+            socket_.set(zmq::sockopt::rcvtimeo, remaining_ms);
+            
+            zmq::message_t zmq_msg;
+            auto result = socket_.recv(zmq_msg, zmq::recv_flags::none);
+            
+            socket_.set(zmq::sockopt::rcvtimeo, -1);
+            
+            if (!result) {
+                return false;
+            }
+            if (!MessageSerializer::deserialize_from_frame(zmq_msg, message)) {
                 monitor_->record_error("Deserialization failed");
                 return false;
             }
-        } else {
-            return false;
+            monitor_->record_receive(zmq_msg.size());
+            if (accept_sequence(message)) {
+                return true;
+            }
+            
+            if (timeout_ms >= 0) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()).count();
+                remaining_ms = static_cast<int>(std::max<int64_t>(left, 0));
+            }
         }
     } catch (const zmq::error_t& e) {
         if (e.num() == EAGAIN) {
@@ -122,31 +138,33 @@ bool ZmqSubscriber::receive_with_topic(std::string& topic, google::protobuf::Mes
     }
     
     try {
-        zmq::message_t topic_msg;
-        auto result = socket_.recv(topic_msg, zmq::recv_flags::none);
-        
-        if (!result) {
-            monitor_->record_error("Failed to receive topic frame");
-            return false;
-        }
-        
-        topic = std::string(static_cast<char*>(topic_msg.data()), topic_msg.size());
-        
-        zmq::message_t data_msg;
-        result = socket_.recv(data_msg, zmq::recv_flags::none);
-        
-        if (result) {
-            std::string data(static_cast<char*>(data_msg.data()), data_msg.size());
-            if (MessageSerializer::deserialize(data, message)) {
-                monitor_->record_receive(topic_msg.size() + data_msg.size());
-                return true;
-            } else {
+        // Stale messages are dropped here; wait on for the next one
+        while (true) {
+            zmq::message_t topic_msg;
+            auto result = socket_.recv(topic_msg, zmq::recv_flags::none);
+            
+            if (!result) {
+                monitor_->record_error("Failed to receive topic frame");
+                return false;
+            }
+            
+            topic.assign(static_cast<const char*>(topic_msg.data()), topic_msg.size());
+            
+            zmq::message_t data_msg;
+            result = socket_.recv(data_msg, zmq::recv_flags::none);
+            
+            if (!result) {
+                monitor_->record_error("Failed to receive data frame");
+                return false;
+            }
+            if (!MessageSerializer::deserialize_from_frame(data_msg, message)) {
                 monitor_->record_error("Deserialization failed");
                 return false;
             }
-        } else {
-            monitor_->record_error("Failed to receive data frame");
-            return false;
+            monitor_->record_receive(topic_msg.size() + data_msg.size());
+            if (accept_sequence(message)) {
+                return true;
+            }
         }
     } catch (const zmq::error_t& e) {
         monitor_->record_error(std::string("Receive with topic failed: ") + e.what());
@@ -155,7 +173,63 @@ bool ZmqSubscriber::receive_with_topic(std::string& topic, google::protobuf::Mes
     }
 }
 
+void ZmqSubscriber::enable_gap_detection(SequenceReader reader,
+                                         const std::string& recovery_endpoint,
+                                         RecoveryHandler on_gap) {
+    sequence_reader_ = std::move(reader);
+    recovery_handler_ = std::move(on_gap);
+    recovery_.reset();
+    
+    if (!recovery_endpoint.empty() && recovery_handler_) {
+        recovery_ = std::make_unique<ZmqRequester>(context_, name_ + "_Recovery", recovery_endpoint);
+        recovery_->set_relaxed(kRecoveryTimeoutMs);  // A lost reply must not wedge the socket
+        recovery_->connect();
+    }
+}
+
+void ZmqSubscriber::reset_sequence(const std::string& stream, uint64_t sequence) {
+    gap_detector_.reset(stream, sequence);
+}
+
+bool ZmqSubscriber::accept_sequence(const google::protobuf::Message& message) {
+    std::string stream;
+    uint64_t sequence = 0;
+    if (!sequence_reader_ || !sequence_reader_(message, stream, sequence)) {
+        return true;
+    }
+    
+    switch (gap_detector_.check(stream, sequence)) {
+        case SequenceGapDetector::Result::IN_ORDER:
+            return true;
+        case SequenceGapDetector::Result::STALE:
+            return false;
+        case SequenceGapDetector::Result::GAP:
+            break;
+    }
+    
+    monitor_->record_error("Sequence gap on " + stream + " at " + std::to_string(sequence));
+    if (!recovery_) {
+        return true;  // Detect only: the stream carries on from here
+    }
+    
+    auto recovered = recovery_handler_(stream, *recovery_);
+    if (!recovered) {
+        monitor_->record_error("Recovery failed for " + stream);
+        return true;
+    }
+    
+    // The snapshot may already include this message
+    if (sequence <= *recovered) {
+        gap_detector_.reset(stream, *recovered);
+        return false;
+    }
+    return true;
+}
+
 void ZmqSubscriber::close() {
+    if (recovery_) {
+        recovery_->close();
+    }
     if (connected_) {
         socket_.close();
         connected_ = false;
@@ -2,12 +2,16 @@
 
 #include "io_context.h"
 #include "message_serializer.h"
+#include "sequence_gap_detector.h"
+#include "zmq_requester.h"
 #include "monitor/monitor_helpers.h"
 #include "monitor/socket_info.h"
 #include <zmq.hpp>
 #include <string>
 #include <memory>
 #include <optional>
+#include <functional>
+#include <cstdint>
 #include <google/protobuf/message.h>
 
 namespace marketsim::io_handler {
@@ -17,9 +21,31 @@ namespace marketsim::io_handler {
  * 
  * Used for receiving market data broadcasts.
  * Each instance is owned by a single thread pool.
+ *
+ * Optionally checks sequence numbers on every message received: stale
+ * messages (duplicates, or already covered by a snapshot) are dropped and the
+ * receive call waits on for the next one, and a gap triggers a snapshot
+ * request over a recovery REQ/REP endpoint before the message that revealed
+ * it is delivered. The recovery socket is relaxed (see ZmqRequester::set_relaxed),
+ * so an unanswered request can be retried.
  */
 class ZmqSubscriber {
 public:
+    /**
+     * @brief Reads the stream key and sequence of a received message
+     * @return false if the message isn't part of a sequenced stream (e.g. a snapshot)
+     */
+    using SequenceReader = std::function<bool(const google::protobuf::Message& message,
+                                              std::string& stream, uint64_t& sequence)>;
+    
+    /**
+     * @brief Fetches and applies a snapshot for a stream over the recovery requester
+     * (request() on it gives up after kRecoveryTimeoutMs; retrying is safe)
+     * @return Sequence the snapshot is current to, or nullopt if recovery failed
+     */
+    using RecoveryHandler = std::function<std::optional<uint64_t>(const std::string& stream,
+                                                                  ZmqRequester& recovery)>;
+    
     /**
      * @brief Construct a subscriber
      * @param context IOContext for this component
@@ -28,6 +54,9 @@ public:
      */
     ZmqSubscriber(IOContext& context, const std::string& name, const std::string& endpoint);
     
+    // Longest a recovery request() waits for its snapshot
+    static constexpr int kRecoveryTimeoutMs = 1000;
+    
     ~ZmqSubscriber();
     
     /**
@@ -58,7 +87,7 @@ public:
     /**
      * @brief Receive a message with timeout
      * @param message Output message to populate
-     * @param timeout_ms Timeout in milliseconds
+     * @param timeout_ms Timeout in milliseconds (for the whole call, stale messages included)
      * @return true if message received, false on timeout or error
      */
     bool receive_with_timeout(google::protobuf::Message& message, int timeout_ms);
@@ -71,6 +100,28 @@ public:
      */
     bool receive_with_topic(std::string& topic, google::protobuf::Message& message);
     
+    /**
+     * @brief Check sequence numbers on received messages, recovering on gaps
+     * @param reader Extracts stream and sequence from a message
+     * @param recovery_endpoint Recovery REP endpoint (e.g., "tcp://localhost:5559"; "" = detect only)
+     * @param on_gap Requests and applies the snapshot (ignored without an endpoint)
+     * @throws zmq::error_t if the recovery socket can't connect
+     */
+    void enable_gap_detection(SequenceReader reader,
+                              const std::string& recovery_endpoint = "",
+                              RecoveryHandler on_gap = {});
+    
+    /**
+     * @brief Mark a stream as current up to sequence (call after applying a snapshot
+     * received some other way, e.g. a periodic one on the feed)
+     */
+    void reset_sequence(const std::string& stream, uint64_t sequence);
+    
+    /**
+     * @brief Gap/stale statistics
+     */
+    const SequenceGapDetector& gap_detector() const { return gap_detector_; }
+    
     /**
      * @brief Close the socket
      */
@@ -82,10 +133,21 @@ public:
     bool is_connected() const;
     
 private:
+    // false if the message should be dropped (the caller then reads the next one)
+    bool accept_sequence(const google::protobuf::Message& message);
+    
+    IOContext& context_;
+    std::string name_;
     zmq::socket_t socket_;
     std::string endpoint_;
     bool connected_;
     std::unique_ptr<monitor::MonitoredSocket> monitor_;
+    
+    // Gap detection (off unless enabled)
+    SequenceReader sequence_reader_;
+    RecoveryHandler recovery_handler_;
+    std::unique_ptr<ZmqRequester> recovery_;
+    SequenceGapDetector gap_detector_;
 };
 
 }
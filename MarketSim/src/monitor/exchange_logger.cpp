@@ -26,11 +26,11 @@ void ExchangeLogger::log_matching_result(
     const exchange::operations::MatchResult& result)
 {
     if (result.success) {
-        if (result.trades.empty()) {
+        if (result.fill_count == 0) {
             std::cout << "[MATCHING] " << order_id << " -> ADDED (no match)\n";
         } else {
             std::cout << "[MATCHING] " << order_id << " -> MATCHED "
-                      << result.trades.size() << " trades, "
+                      << result.fill_count << " trades, "
                       << result.executed_quantity << "@"
                       << std::fixed << std::setprecision(2) << result.execution_price << "\n";
         }
@@ -105,8 +105,8 @@ void ExchangeLogger::log_orderbook(
             const auto& buy = buy_levels[i];
             std::ostringstream ps, qs, os;
             ps << std::fixed << std::setprecision(2) << "$" << buy.price;
-            qs << std::fixed << std::setprecision(2) << buy.total_quantity();
-            os << buy.orders.size();
+            qs << std::fixed << std::setprecision(2) << buy.quantity;
+            os << buy.order_count;
             buy_price = ps.str();
             buy_qty = qs.str();
             buy_orders = os.str();
@@ -117,8 +117,8 @@ void ExchangeLogger::log_orderbook(
             const auto& sell = sell_levels[i];
             std::ostringstream ps, qs, os;
             ps << std::fixed << std::setprecision(2) << "$" << sell.price;
-            qs << std::fixed << std::setprecision(2) << sell.total_quantity();
-            os << sell.orders.size();
+            qs << std::fixed << std::setprecision(2) << sell.quantity;
+            os << sell.order_count;
             sell_price = ps.str();
             sell_qty = qs.str();
             sell_orders = os.str();
@@ -11,14 +11,22 @@ ExchangeMonitor::ExchangeMonitor(const MonitorConfig& config)
     : config_(config)
     , io_context_(1)
     , running_(false)
-    , last_processed_tick_timestamp_(0)
+    , last_processed_tick_sequence_(0)
+    , trade_cursor_(0)
+    , mid_cursor_(0)
+    , poll_arena_block_(std::make_unique<char[]>(kPollArenaBlock))
+    , poll_arena_(poll_arena_block_.get(), kPollArenaBlock)
 {
 }
 
 ExchangeMonitor::ExchangeMonitor(const std::string& status_endpoint)
     : io_context_(1)
     , running_(false)
-    , last_processed_tick_timestamp_(0)
+    , last_processed_tick_sequence_(0)
+    , trade_cursor_(0)
+    , mid_cursor_(0)
+    , poll_arena_block_(std::make_unique<char[]>(kPollArenaBlock))
+    , poll_arena_(poll_arena_block_.get(), kPollArenaBlock)
 {
     config_.exchange_status_endpoint = status_endpoint;
 }
@@ -120,13 +128,27 @@ void ExchangeMonitor::run_monitor_loop() {
 }
 
 void ExchangeMonitor::query_and_display_status() {
+// Last poll's messages are no longer referenced
+poll_arena_.Reset();
+
 // Create status request
-exchange::StatusRequest request;
+auto& request = *google::protobuf::Arena::CreateMessage<exchange::StatusRequest>(&poll_arena_);
 request.set_request_type("full");
 request.set_symbol(config_.ticker);  // Use ticker from config
+
+// Only ticks newer than the last poll, and only the parts someone consumes
+bool recording = history_recorder_ && history_recorder_->is_recording();
+const auto& history_config = config_.history_config;
+request.set_since_trade_seq(trade_cursor_);
+request.set_since_mid_seq(mid_cursor_);
+auto* fields = request.mutable_fields();
+fields->set_skip_trade_history(!config_.enable_ohlcv && !(recording && history_config.record_trade_prices));
+fields->set_skip_mid_history(!(recording && history_config.record_mid_prices));
+fields->set_skip_orderbook(!config_.show_orderbook && !(recording && history_config.record_orderbook_snapshots));
+fields->set_skip_latency(true);
     
 // Send request and receive response
-exchange::StatusResponse response;
+auto& response = *google::protobuf::Arena::CreateMessage<exchange::StatusResponse>(&poll_arena_);
     
     try {
         if (!status_requester_->request(request, response)) {
@@ -137,20 +159,32 @@ exchange::StatusResponse response;
         return;
     }
     
+    // Next poll picks up where this one ended
+    trade_cursor_ = response.trade_history_sequence();
+    mid_cursor_ = response.mid_history_sequence();
+    if (response.history_truncated()) {
+        std::cerr << "[MONITOR] Polling fell behind the exchange's price history; ticks were skipped\n";
+    }
+    
     // Record to history if enabled
-    if (history_recorder_ && history_recorder_->is_recording()) {
+    if (recording) {
         history_recorder_->record_status(response);
     }
 
     // === OHLCV PROCESSING (Display FIRST) ===
     if (ohlcv_builder_ && config_.enable_ohlcv) {
-        // Process only NEW ticks since last poll
+        // Process only NEW ticks since last poll (by sequence: ticks can share a millisecond)
+        const auto& ticks = response.trade_price_history();
+        if (!ticks.empty() && ticks.rbegin()->sequence() < last_processed_tick_sequence_) {
+            last_processed_tick_sequence_ = 0;  // Exchange restarted
+        }
+        
         int new_ticks = 0;
-        for (const auto& tick : response.trade_price_history()) {
-            if (tick.timestamp_ms() > last_processed_tick_timestamp_) {
+        for (const auto& tick : ticks) {
+            if (tick.sequence() > last_processed_tick_sequence_) {
                 // Volume = 1.0 per tick (can be enhanced later)
                 ohlcv_builder_->process_tick(tick.price(), tick.timestamp_ms(), 1.0);
-                last_processed_tick_timestamp_ = tick.timestamp_ms();
+                last_processed_tick_sequence_ = tick.sequence();
                 new_ticks++;
             }
         }
@@ -5,6 +5,7 @@
 #include "io_handler/zmq_requester.h"
 #include "io_handler/ohlcv_builder.h"
 #include "exchange/operations/matching_engine.h"
+#include <google/protobuf/arena.h>
 #include <memory>
 #include <atomic>
 #include <thread>
@@ -67,7 +68,17 @@ private:
     std::unique_ptr<io_handler::ZmqRequester> status_requester_;
     std::unique_ptr<HistoryRecorder> history_recorder_;
     std::unique_ptr<io_handler::OHLCVBuilder> ohlcv_builder_;
-    int64_t last_processed_tick_timestamp_;
+    uint64_t last_processed_tick_sequence_;
+
+    // Status cursors: newest trade/mid tick sequence already received
+    uint64_t trade_cursor_;
+    uint64_t mid_cursor_;
+
+    // Each poll's request/response tree is built on this arena and dropped
+    // with one Reset(); the first block is reused so polling doesn't churn the heap
+    static constexpr size_t kPollArenaBlock = 256 * 1024;
+    std::unique_ptr<char[]> poll_arena_block_;
+    google::protobuf::Arena poll_arena_;
 
     std::unique_ptr<std::thread> monitor_thread_;
     std::atomic<bool> running_;
@@ -10,8 +10,8 @@ HistoryRecorder::HistoryRecorder(const HistoryRecorderConfig& config)
     : config_(config)
     , recording_(false)
     , record_count_(0)
-    , last_trade_timestamp_written_(0)
-    , last_mid_timestamp_written_(0)
+    , last_trade_sequence_written_(0)
+    , last_mid_sequence_written_(0)
     , last_ohlcv_timestamp_written_(0)
 {
     // Create output directory if it doesn't exist
@@ -67,11 +67,17 @@ auto session_elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
 if (config_.record_trade_prices && trade_price_file_.is_open()) {
     int new_entries = 0;
         
-    for (int i = 0; i < response.trade_price_history_size(); ++i) {
+    // Sequences restart with the exchange
+    int trade_count = response.trade_price_history_size();
+    if (trade_count > 0 && response.trade_price_history(trade_count - 1).sequence() < last_trade_sequence_written_) {
+        last_trade_sequence_written_ = 0;
+    }
+        
+    for (int i = 0; i < trade_count; ++i) {
         const auto& tick = response.trade_price_history(i);
             
-        // Skip if we already wrote this timestamp
-        if (tick.timestamp_ms() <= last_trade_timestamp_written_) {
+        // Skip if we already wrote this tick
+        if (tick.sequence() <= last_trade_sequence_written_) {
             continue;
         }
             
@@ -99,8 +105,8 @@ if (config_.record_trade_prices && trade_price_file_.is_open()) {
                          << tick.timestamp_ms() << ","
                          << tick.price() << "\n";
             
-        // Update last written timestamp
-        last_trade_timestamp_written_ = tick.timestamp_ms();
+        // Update last written tick
+        last_trade_sequence_written_ = tick.sequence();
     }
         
     if (new_entries > 0) {
@@ -115,11 +121,17 @@ if (config_.record_trade_prices && trade_price_file_.is_open()) {
     if (config_.record_mid_prices && mid_price_file_.is_open()) {
         int new_entries = 0;
         
-        for (int i = 0; i < response.mid_price_history_size(); ++i) {
+        // Sequences restart with the exchange
+        int mid_count = response.mid_price_history_size();
+        if (mid_count > 0 && response.mid_price_history(mid_count - 1).sequence() < last_mid_sequence_written_) {
+            last_mid_sequence_written_ = 0;
+        }
+        
+        for (int i = 0; i < mid_count; ++i) {
             const auto& tick = response.mid_price_history(i);
             
-            // Skip if we already wrote this timestamp
-            if (tick.timestamp_ms() <= last_mid_timestamp_written_) {
+            // Skip if we already wrote this tick
+            if (tick.sequence() <= last_mid_sequence_written_) {
                 continue;
             }
             
@@ -162,8 +174,8 @@ if (config_.record_trade_prices && trade_price_file_.is_open()) {
             }
             mid_price_file_ << "\n";
             
-            // Update last written timestamp
-            last_mid_timestamp_written_ = tick.timestamp_ms();
+            // Update last written tick
+            last_mid_sequence_written_ = tick.sequence();
         }
         
         if (new_entries > 0) {
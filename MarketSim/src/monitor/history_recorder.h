@@ -72,9 +72,10 @@ private:
     std::chrono::steady_clock::time_point last_write_time_;
     int record_count_;
 
-    // Track last written timestamps to avoid duplicates
-    int64_t last_trade_timestamp_written_;
-    int64_t last_mid_timestamp_written_;
+    // Track what was last written to avoid duplicates (ticks by sequence,
+    // since several can share a millisecond; bars by timestamp)
+    uint64_t last_trade_sequence_written_;
+    uint64_t last_mid_sequence_written_;
     int64_t last_ohlcv_timestamp_written_;
 };
 
@@ -0,0 +1,79 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace marketsim::monitor {
+
+LatencyHistogram::LatencyHistogram(const std::string& stage)
+    : stage_(stage)
+    , count_(0)
+    , sum_(0)
+    , max_(0)
+{
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t LatencyHistogram::bucket_for(uint64_t ns) {
+    // Exact below 2 * kSubBuckets
+    if (ns < 2 * kSubBuckets) {
+        return static_cast<size_t>(ns);
+    }
+
+    // Top kSubBucketBits + 1 bits select the bucket within the power of two
+    int msb = std::bit_width(ns) - 1;
+    int shift = msb - kSubBucketBits;
+    uint64_t top = ns >> shift;  // In [kSubBuckets, 2 * kSubBuckets)
+    return static_cast<size_t>(2 * kSubBuckets + (shift - 1) * kSubBuckets + (top - kSubBuckets));
+}
+
+uint64_t LatencyHistogram::bucket_upper(size_t index) {
+    if (index < 2 * kSubBuckets) {
+        return index;
+    }
+
+    size_t offset = index - 2 * kSubBuckets;
+    int shift = static_cast<int>(offset / kSubBuckets) + 1;
+    uint64_t top = kSubBuckets + offset % kSubBuckets;
+    return ((top + 1) << shift) - 1;
+}
+
+void LatencyHistogram::merge_into(LatencyCounts& out) const {
+    if (out.buckets.size() < kBucketCount) {
+        out.buckets.resize(kBucketCount, 0);
+    }
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        out.buckets[i] += buckets_[i].load(std::memory_order_relaxed);
+    }
+    out.count += count_.load(std::memory_order_relaxed);
+    out.sum_ns += sum_.load(std::memory_order_relaxed);
+    out.max_ns = std::max(out.max_ns, max_.load(std::memory_order_relaxed));
+}
+
+uint64_t LatencyCounts::value_at(double quantile) const {
+    // Ranked against the buckets themselves: count may be read a little apart from them
+    uint64_t total = 0;
+    for (uint64_t n : buckets) {
+        total += n;
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(total)));
+    rank = std::clamp<uint64_t>(rank, 1, total);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            // Never report past the largest value actually seen
+            return std::min(LatencyHistogram::bucket_upper(i), max_ns);
+        }
+    }
+    return max_ns;
+}
+
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace marketsim::monitor {
+
+/**
+ * @brief Merged counts of one or more histograms (reader side)
+ */
+struct LatencyCounts {
+    std::vector<uint64_t> buckets;
+    uint64_t count = 0;
+    uint64_t sum_ns = 0;
+    uint64_t max_ns = 0;
+
+    /**
+     * @brief Smallest recorded value at or above the given fraction of samples
+     * @param quantile 0..1 (e.g. 0.99); reported as its bucket's upper bound
+     */
+    uint64_t value_at(double quantile) const;
+};
+
+/**
+ * @brief Percentile summary of one stage, as reported by StatusMonitor
+ */
+struct LatencyStats {
+    std::string stage;
+    uint64_t count;
+    double mean_ns;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+};
+
+/**
+ * @brief Lock-free log-linear latency histogram (HDR-style)
+ *
+ * Values below 64 ns get a bucket each; above that every power of two is
+ * split into 32 buckets, so any value is reported within ~3% up to ~2 min.
+ * Single writer: each thread records into its own histogram with relaxed
+ * loads and stores (no read-modify-write); other threads may read at any
+ * time and see a slightly stale but never torn count.
+ */
+class alignas(64) LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr uint64_t kSubBuckets = 1ull << kSubBucketBits;
+    static constexpr int kMaxBits = 37;  // Largest trackable value: 2^37 - 1 ns
+    static constexpr size_t kBucketCount = 2 * kSubBuckets + (kMaxBits - kSubBucketBits - 1) * kSubBuckets;
+
+    explicit LatencyHistogram(const std::string& stage);
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Record one sample (owning thread only)
+     */
+    void record(uint64_t ns) {
+        if (ns > kMaxValue) ns = kMaxValue;
+        auto& bucket = buckets_[bucket_for(ns)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sum_.store(sum_.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+        if (ns > max_.load(std::memory_order_relaxed)) {
+            max_.store(ns, std::memory_order_relaxed);
+        }
+    }
+
+    void record(std::chrono::steady_clock::duration elapsed) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+    }
+
+    /**
+     * @brief Add this histogram's counts to out (any thread)
+     */
+    void merge_into(LatencyCounts& out) const;
+
+    const std::string& stage() const { return stage_; }
+
+    static size_t bucket_for(uint64_t ns);
+    static uint64_t bucket_upper(size_t index);
+
+private:
+    static constexpr uint64_t kMaxValue = (1ull << kMaxBits) - 1;
+
+    std::string stage_;
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_;
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> max_;
+};
+
+/**
+ * @brief Records the time from construction to destruction
+ */
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram& histogram)
+        : histogram_(histogram)
+        , start_(std::chrono::steady_clock::now())
+    {}
+
+    ~ScopedLatency() {
+        histogram_.record(std::chrono::steady_clock::now() - start_);
+    }
+
+private:
+    LatencyHistogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "status_monitor.h"
+#include <memory>
 #include <thread>
 
 namespace marketsim::monitor {
@@ -39,8 +40,8 @@ class MonitoredSocket {
 public:
     MonitoredSocket(const std::string& name, SocketType type, const std::string& endpoint)
         : name_(name)
+        , counters_(StatusMonitor::instance().register_socket(name, type, endpoint))
     {
-        StatusMonitor::instance().register_socket(name, type, endpoint);
     }
     
     ~MonitoredSocket() {
@@ -51,12 +52,13 @@ public:
         StatusMonitor::instance().update_socket_state(name_, state);
     }
     
+    // Lock-free: a few relaxed increments on this socket's own cache line
     void record_send(size_t bytes) {
-        StatusMonitor::instance().record_socket_send(name_, bytes);
+        counters_->record_send(bytes);
     }
     
     void record_receive(size_t bytes) {
-        StatusMonitor::instance().record_socket_receive(name_, bytes);
+        counters_->record_receive(bytes);
     }
     
     void record_error(const std::string& error) {
@@ -65,6 +67,7 @@ public:
     
 private:
     std::string name_;
+    std::shared_ptr<SocketCounters> counters_;
 };
 
 }
@@ -2,6 +2,8 @@
 
 #include <string>
 #include <chrono>
+#include <atomic>
+#include <cstdint>
 
 namespace marketsim::monitor {
 
@@ -71,6 +73,31 @@ struct SocketInfo {
     {}
 };
 
+/**
+ * @brief Hot-path message counters of one socket
+ *
+ * Handed out by StatusMonitor::register_socket; the owning I/O thread bumps
+ * them with relaxed atomics (no lock, no lookup) and the monitor folds them
+ * into SocketInfo when it reads. One cache line per socket, so sockets
+ * driven by different threads don't share a line.
+ */
+struct alignas(64) SocketCounters {
+    std::atomic<uint64_t> messages_sent{0};
+    std::atomic<uint64_t> messages_received{0};
+    std::atomic<uint64_t> bytes_sent{0};
+    std::atomic<uint64_t> bytes_received{0};
+    
+    void record_send(size_t bytes) {
+        messages_sent.fetch_add(1, std::memory_order_relaxed);
+        bytes_sent.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    
+    void record_receive(size_t bytes) {
+        messages_received.fetch_add(1, std::memory_order_relaxed);
+        bytes_received.fetch_add(bytes, std::memory_order_relaxed);
+    }
+};
+
 inline std::string to_string(SocketType type) {
     switch (type) {
         case SocketType::REQ: return "REQ";
@@ -67,9 +67,14 @@ void StatusMonitor::unregister_thread(std::thread::id thread_id) {
 }
 
 // Socket monitoring implementation
-void StatusMonitor::register_socket(const std::string& name, SocketType type, const std::string& endpoint) {
+std::shared_ptr<SocketCounters> StatusMonitor::register_socket(const std::string& name, SocketType type, const std::string& endpoint) {
     std::lock_guard<std::mutex> lock(sockets_mutex_);
     sockets_[name] = SocketInfo(name, type, endpoint);
+    
+    // Re-registering starts from zero; a previous owner's handle stays valid but is no longer read
+    auto counters = std::make_shared<SocketCounters>();
+    socket_counters_[name] = counters;
+    return counters;
 }
 
 void StatusMonitor::update_socket_state(const std::string& name, SocketState state) {
@@ -83,21 +88,17 @@ void StatusMonitor::update_socket_state(const std::string& name, SocketState sta
 
 void StatusMonitor::record_socket_send(const std::string& name, size_t bytes) {
     std::lock_guard<std::mutex> lock(sockets_mutex_);
-    auto it = sockets_.find(name);
-    if (it != sockets_.end()) {
-        it->second.messages_sent++;
-        it->second.bytes_sent += bytes;
-        it->second.last_activity = std::chrono::system_clock::now();
+    auto it = socket_counters_.find(name);
+    if (it != socket_counters_.end()) {
+        it->second->record_send(bytes);
     }
 }
 
 void StatusMonitor::record_socket_receive(const std::string& name, size_t bytes) {
     std::lock_guard<std::mutex> lock(sockets_mutex_);
-    auto it = sockets_.find(name);
-    if (it != sockets_.end()) {
-        it->second.messages_received++;
-        it->second.bytes_received += bytes;
-        it->second.last_activity = std::chrono::system_clock::now();
+    auto it = socket_counters_.find(name);
+    if (it != socket_counters_.end()) {
+        it->second->record_receive(bytes);
     }
 }
 
@@ -120,6 +121,43 @@ void StatusMonitor::unregister_socket(const std::string& name) {
     }
 }
 
+void StatusMonitor::refresh_socket_counters() const {
+    auto now = std::chrono::system_clock::now();
+    for (const auto& [name, counters] : socket_counters_) {
+        auto it = sockets_.find(name);
+        if (it == sockets_.end()) {
+            continue;
+        }
+        
+        SocketInfo& info = it->second;
+        size_t sent = counters->messages_sent.load(std::memory_order_relaxed);
+        size_t received = counters->messages_received.load(std::memory_order_relaxed);
+        
+        // Traffic since the last read counts as activity (to read resolution)
+        if (sent != info.messages_sent || received != info.messages_received) {
+            info.last_activity = now;
+        }
+        info.messages_sent = sent;
+        info.messages_received = received;
+        info.bytes_sent = counters->bytes_sent.load(std::memory_order_relaxed);
+        info.bytes_received = counters->bytes_received.load(std::memory_order_relaxed);
+    }
+}
+
+// Latency monitoring implementation
+std::shared_ptr<LatencyHistogram> StatusMonitor::register_latency(const std::string& stage) {
+    std::lock_guard<std::mutex> lock(latency_mutex_);
+    
+    // Forget histograms whose owners are gone (e.g. a restarted thread's)
+    latencies_.erase(std::remove_if(latencies_.begin(), latencies_.end(),
+                                    [](const auto& entry) { return entry.expired(); }),
+                     latencies_.end());
+    
+    auto histogram = std::make_shared<LatencyHistogram>(stage);
+    latencies_.push_back(histogram);
+    return histogram;
+}
+
 // Status retrieval
 std::vector<ThreadInfo> StatusMonitor::get_thread_status() const {
     std::lock_guard<std::mutex> lock(threads_mutex_);
@@ -133,6 +171,7 @@ std::vector<ThreadInfo> StatusMonitor::get_thread_status() const {
 
 std::vector<SocketInfo> StatusMonitor::get_socket_status() const {
     std::lock_guard<std::mutex> lock(sockets_mutex_);
+    refresh_socket_counters();
     std::vector<SocketInfo> result;
     result.reserve(sockets_.size());
     for (const auto& [name, info] : sockets_) {
@@ -149,10 +188,48 @@ ThreadInfo StatusMonitor::get_thread_info(std::thread::id thread_id) const {
 
 SocketInfo StatusMonitor::get_socket_info(const std::string& name) const {
     std::lock_guard<std::mutex> lock(sockets_mutex_);
+    refresh_socket_counters();
     auto it = sockets_.find(name);
     return (it != sockets_.end()) ? it->second : SocketInfo();
 }
 
+std::vector<LatencyStats> StatusMonitor::get_latency_status() const {
+    std::lock_guard<std::mutex> lock(latency_mutex_);
+    
+    // Merge every thread's histogram for a stage
+    std::vector<std::string> stages;
+    std::vector<LatencyCounts> merged;
+    for (const auto& entry : latencies_) {
+        auto histogram = entry.lock();
+        if (!histogram) {
+            continue;  // Owner gone: its counts went with it
+        }
+        auto it = std::find(stages.begin(), stages.end(), histogram->stage());
+        size_t index = it - stages.begin();
+        if (it == stages.end()) {
+            stages.push_back(histogram->stage());
+            merged.emplace_back();
+        }
+        histogram->merge_into(merged[index]);
+    }
+    
+    std::vector<LatencyStats> result;
+    result.reserve(stages.size());
+    for (size_t i = 0; i < stages.size(); ++i) {
+        const auto& counts = merged[i];
+        result.push_back(LatencyStats{
+            stages[i],
+            counts.count,
+            counts.count > 0 ? static_cast<double>(counts.sum_ns) / counts.count : 0.0,
+            counts.value_at(0.5),
+            counts.value_at(0.99),
+            counts.value_at(0.999),
+            counts.max_ns
+        });
+    }
+    return result;
+}
+
 // Periodic monitoring
 void StatusMonitor::start_periodic_monitoring(std::chrono::milliseconds interval) {
     if (monitoring_running_) {
@@ -210,6 +287,7 @@ void StatusMonitor::check_thread_health() {
 
 void StatusMonitor::check_socket_health() {
     std::lock_guard<std::mutex> lock(sockets_mutex_);
+    refresh_socket_counters();
     auto now = std::chrono::system_clock::now();
     
     for (auto& [name, info] : sockets_) {
@@ -313,6 +391,7 @@ size_t StatusMonitor::active_socket_count() const {
 
 size_t StatusMonitor::total_messages_sent() const {
     std::lock_guard<std::mutex> lock(sockets_mutex_);
+    refresh_socket_counters();
     size_t total = 0;
     for (const auto& [name, info] : sockets_) {
         total += info.messages_sent;
@@ -322,6 +401,7 @@ size_t StatusMonitor::total_messages_sent() const {
 
 size_t StatusMonitor::total_messages_received() const {
     std::lock_guard<std::mutex> lock(sockets_mutex_);
+    refresh_socket_counters();
     size_t total = 0;
     for (const auto& [name, info] : sockets_) {
         total += info.messages_received;
@@ -397,6 +477,37 @@ void StatusMonitor::print_status() const {
         }
     }
     
+    // Latency
+    auto latencies = get_latency_status();
+    if (!latencies.empty()) {
+        std::cout << "\n--- LATENCY (us) ---" << std::endl;
+        std::cout << std::left
+                  << std::setw(20) << "Stage"
+                  << std::setw(12) << "Count"
+                  << std::setw(10) << "Mean"
+                  << std::setw(10) << "p50"
+                  << std::setw(10) << "p99"
+                  << std::setw(10) << "p99.9"
+                  << std::setw(10) << "Max" << std::endl;
+        std::cout << std::string(80, '-') << std::endl;
+        
+        auto us = [](double ns) { return ns / 1000.0; };
+        std::ostringstream row;
+        row << std::fixed << std::setprecision(1);
+        for (const auto& stage : latencies) {
+            row.str("");
+            row << std::left
+                << std::setw(20) << stage.stage
+                << std::setw(12) << stage.count
+                << std::setw(10) << us(stage.mean_ns)
+                << std::setw(10) << us(static_cast<double>(stage.p50_ns))
+                << std::setw(10) << us(static_cast<double>(stage.p99_ns))
+                << std::setw(10) << us(static_cast<double>(stage.p999_ns))
+                << std::setw(10) << us(static_cast<double>(stage.max_ns));
+            std::cout << row.str() << std::endl;
+        }
+    }
+    
     // Summary
     std::cout << "\n--- SUMMARY ---" << std::endl;
     std::cout << "Active Threads: " << active_thread_count() << " / " << threads.size() << std::endl;
@@ -2,6 +2,7 @@
 
 #include "thread_info.h"
 #include "socket_info.h"
+#include "latency_histogram.h"
 #include <unordered_map>
 #include <vector>
 #include <memory>
@@ -36,19 +37,26 @@ public:
     void increment_thread_tasks(std::thread::id thread_id);
     void unregister_thread(std::thread::id thread_id);
     
-    // Socket monitoring
-    void register_socket(const std::string& name, SocketType type, const std::string& endpoint);
+    // Socket monitoring: count through the returned handle on the hot path;
+    // record_socket_send/receive by name take the lock and are for occasional use
+    std::shared_ptr<SocketCounters> register_socket(const std::string& name, SocketType type, const std::string& endpoint);
     void update_socket_state(const std::string& name, SocketState state);
     void record_socket_send(const std::string& name, size_t bytes);
     void record_socket_receive(const std::string& name, size_t bytes);
     void record_socket_error(const std::string& name, const std::string& error);
     void unregister_socket(const std::string& name);
     
+    // Latency monitoring: each thread registers its own histogram per stage and
+    // records into it without locking; the monitor only watches it, so once the
+    // owner drops the handle the histogram (and its counts) leave the status
+    std::shared_ptr<LatencyHistogram> register_latency(const std::string& stage);
+    
     // Status retrieval
     std::vector<ThreadInfo> get_thread_status() const;
     std::vector<SocketInfo> get_socket_status() const;
     ThreadInfo get_thread_info(std::thread::id thread_id) const;
     SocketInfo get_socket_info(const std::string& name) const;
+    std::vector<LatencyStats> get_latency_status() const;  // Merged per stage, in registration order
     
     // Periodic monitoring control
     void start_periodic_monitoring(std::chrono::milliseconds interval = std::chrono::seconds(5));
@@ -86,12 +94,19 @@ private:
     void check_socket_health();
     void log_to_file(const std::string& message);
     
+    // Fold the lock-free counters into sockets_ (sockets_mutex_ held)
+    void refresh_socket_counters() const;
+    
     mutable std::mutex threads_mutex_;
     mutable std::mutex sockets_mutex_;
     mutable std::mutex file_mutex_;
+    mutable std::mutex latency_mutex_;  // Registration and reads only, never recording
     
     std::unordered_map<std::thread::id, ThreadInfo> threads_;
-    std::unordered_map<std::string, SocketInfo> sockets_;
+    // Counts and last_activity in sockets_ are refreshed from socket_counters_ on read
+    mutable std::unordered_map<std::string, SocketInfo> sockets_;
+    std::unordered_map<std::string, std::shared_ptr<SocketCounters>> socket_counters_;
+    std::vector<std::weak_ptr<LatencyHistogram>> latencies_;   // Registration order
     
     // Previous state for change detection
     mutable std::unordered_map<std::thread::id, ThreadState> prev_thread_states_;
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include "common/clock/sim_clock.h"
 #include <string>
 #include <cstdint>
 #include <map>
@@ -50,6 +51,7 @@ struct GenerationParameters {
     double order_quantity;
     double step_interval_ms;
     double duration_seconds;
+    common::clock::ClockMode clock_mode;    // REAL_TIME paces steps; VIRTUAL runs them back to back
 
     // Base parameters (used when regime switching is disabled)
     double drift;
@@ -65,6 +67,9 @@ struct GenerationParameters {
     double volume_sigma;
     int orders_per_event;
 
+    // Order entry
+    int max_in_flight_batches;              // Order batches allowed to await an ack at once
+
     // Regime switching configuration
     bool enable_regime_switching;
     double regime_switch_interval_seconds;  // How often to check for regime switch (10s)
@@ -80,6 +85,7 @@ struct GenerationParameters {
         , order_quantity(1.0)
         , step_interval_ms(10.0)
         , duration_seconds(300.0)
+        , clock_mode(common::clock::ClockMode::REAL_TIME)
         , drift(5.0)
         , volatility(3.0)
         , hawkes_mu(10.0)
@@ -92,6 +98,7 @@ struct GenerationParameters {
         , volume_mu(0.0)
         , volume_sigma(0.5)
         , orders_per_event(5)
+        , max_in_flight_batches(64)
         , enable_regime_switching(true)
         , regime_switch_interval_seconds(10.0)
     {
@@ -1,5 +1,4 @@
 #include "generation_thread.h"
-#include "../utils/time_utils.h"
 #include "exchange.pb.h"
 #include <iostream>
 
@@ -10,6 +9,7 @@ GenerationThread::GenerationThread(
     io_handler::IOContext& io_context,
     const std::string& endpoint)
     : params_(params)
+    , clock_(params.clock_mode)
     , price_calculator_(params.base_price, params.price_rate)
     , running_(false)
 {
@@ -56,6 +56,7 @@ void GenerationThread::run() {
     std::cout << "  Price Rate: " << params_.price_rate << " per second\n";
     std::cout << "  Interval: " << params_.step_interval_ms << " ms\n";
     std::cout << "  Duration: " << params_.duration_seconds << " seconds\n";
+    std::cout << "  Clock: " << common::clock::to_string(clock_.mode()) << "\n";
     
     // Connect requester to Exchange
     try {
@@ -68,7 +69,8 @@ void GenerationThread::run() {
     }
     
     // Initialize state
-    state_.start_timestamp_ms = utils::TimeUtils::current_timestamp_ms();
+    clock_.restart();  // Model time starts once connected
+    state_.start_timestamp_ms = clock_.now_ms();
     state_.is_running = true;
     state_.orders_sent = 0;
     
@@ -77,15 +79,15 @@ void GenerationThread::run() {
     double step_seconds = params_.step_interval_ms / 1000.0;
     
     while (running_ && t <= params_.duration_seconds) {
+        // Wait for (real time) or jump to (virtual) this step's time
+        clock_.advance_to_seconds(t);
+        
         // Send orders at current time
         send_orders_at_time(t);
         
         // Update state
         state_.elapsed_seconds = t;
         
-        // Sleep for interval
-        utils::TimeUtils::sleep_ms(static_cast<int64_t>(params_.step_interval_ms));
-        
         // Advance time
         t += step_seconds;
     }
@@ -109,7 +111,7 @@ void GenerationThread::send_orders_at_time(double time_seconds) {
     );
     
     // Send each order via IOHandler
-    int64_t timestamp = utils::TimeUtils::current_timestamp_ms();
+    int64_t timestamp = clock_.now_ms();
     
     for (const auto& order : orders) {
         // Create protobuf Order message
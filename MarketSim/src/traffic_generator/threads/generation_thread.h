@@ -5,6 +5,7 @@
 #include "../models/generation_parameters.h"
 #include "io_handler/zmq_requester.h"
 #include "io_handler/io_context.h"
+#include "common/clock/sim_clock.h"
 #include <thread>
 #include <atomic>
 #include <memory>
@@ -17,7 +18,7 @@ namespace marketsim::traffic_generator::threads {
  * Responsibilities:
  * - Call operations/ to calculate price and generate orders
  * - Serialize and publish orders via IOHandler
- * - Manage timing (0.1s intervals)
+ * - Manage timing (0.1s intervals, on a SimClock in params.clock_mode)
  * - Track generation state
  */
 class GenerationThread {
@@ -62,6 +63,7 @@ private:
     
     models::GenerationParameters params_;
     models::GenerationState state_;
+    common::clock::SimClock clock_;
     
     // Operations (pure math)
     operations::PriceMovementCalculator price_calculator_;
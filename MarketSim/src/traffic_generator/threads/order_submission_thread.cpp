@@ -1,31 +1,40 @@
 #include "order_submission_thread.h"
 #include "exchange.pb.h"
+#include <chrono>
 #include <iostream>
 
 namespace marketsim::traffic_generator::threads {
 
+namespace {
+
+// Outstanding batches with no ack after this long are dropped from the window
+constexpr auto kAckTimeout = std::chrono::milliseconds(5000);
+
+}
+
 OrderSubmissionThread::OrderSubmissionThread(
     io_handler::IOContext& io_context,
     const std::string& endpoint,
-    std::queue<PriceGenerationThread::Order>& queue,
-    std::mutex& queue_mutex,
-    std::condition_variable& queue_cv)
+    PriceGenerationThread::OrderQueue& queue,
+    size_t max_in_flight)
     : queue_(queue)
-    , queue_mutex_(queue_mutex)
-    , queue_cv_(queue_cv)
     , orders_sent_(0)
+    , orders_acked_(0)
+    , next_batch_id_(1)
     , running_(false)
 {
-    // Create ZeroMQ requester for sending orders to Exchange
-    requester_ = std::make_unique<io_handler::ZmqRequester>(
+    // DEALER requester: batches are pipelined, acks matched by batch id
+    requester_ = std::make_unique<io_handler::ZmqAsyncRequester>(
         io_context,
         "TrafficGenerator",
-        endpoint
+        endpoint,
+        max_in_flight
     );
     
     // Connect to Exchange
     requester_->connect();
-    std::cout << "[OrderSubmitter] Connected to Exchange at " << endpoint << "\n";
+    std::cout << "[OrderSubmitter] Connected to Exchange at " << endpoint
+              << " (window " << max_in_flight << ")\n";
 }
 
 OrderSubmissionThread::~OrderSubmissionThread() {
@@ -44,9 +53,6 @@ void OrderSubmissionThread::start() {
 void OrderSubmissionThread::stop() {
     running_ = false;
     
-    // Wake up if blocked
-    queue_cv_.notify_all();
-    
     if (thread_ && thread_->joinable()) {
         thread_->join();
     }
@@ -55,68 +61,89 @@ void OrderSubmissionThread::stop() {
 void OrderSubmissionThread::run() {
     std::cout << "[OrderSubmitter] Starting order submission...\n";
     
+    PriceGenerationThread::OrderCloud cloud;
     while (running_) {
-        PriceGenerationThread::Order order;
-        
-        // Pull order from queue (blocking)
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            
-            queue_cv_.wait(lock, [this] { 
-                return !queue_.empty() || !running_; 
-            });
-            
-            if (!running_) {
-                break;
-            }
-            
-            if (!queue_.empty()) {
-                order = queue_.front();
-                queue_.pop();
-            } else {
+        // Idle: block on the ring (timed so stop() is noticed)
+        if (requester_->in_flight() == 0) {
+            if (!queue_.pop_for(cloud, std::chrono::milliseconds(100))) {
                 continue;
             }
+            submit_cloud(cloud);
+        }
+        
+        // Keep the window full
+        while (requester_->can_send() && queue_.try_pop(cloud)) {
+            submit_cloud(cloud);
         }
         
-        // Submit the order (outside lock)
-        submit_order(order);
+        // Window full: wait for acks; otherwise just peek before refilling
+        collect_acks(requester_->can_send() ? 1 : 100);
+        
+        size_t lost = requester_->expire(kAckTimeout);
+        if (lost > 0) {
+            std::cerr << "[OrderSubmitter] " << lost << " batches timed out waiting for ack\n";
+        }
     }
     
     std::cout << "[OrderSubmitter] Submission complete. Total orders sent: " 
-              << orders_sent_ << "\n";
+              << orders_sent_ << ", acked: " << orders_acked_ << "\n";
 }
 
-void OrderSubmissionThread::submit_order(const PriceGenerationThread::Order& order) {
-    // Create protobuf Order message
-    marketsim::exchange::Order proto_order;
-    proto_order.set_order_id(std::to_string(order.order_id));
-    proto_order.set_symbol(order.symbol);
-    proto_order.set_side(order.is_buy ? 
-                         marketsim::exchange::OrderSide::BUY : 
-                         marketsim::exchange::OrderSide::SELL);
-    proto_order.set_type(marketsim::exchange::OrderType::LIMIT);
-    proto_order.set_price(order.price);
-    proto_order.set_quantity(order.volume);
-    proto_order.set_timestamp(static_cast<int64_t>(order.timestamp_seconds * 1000));  // Convert to ms
-    proto_order.set_client_id("TrafficGenerator");
+void OrderSubmissionThread::collect_acks(int timeout_ms) {
+    marketsim::exchange::OrderAckBatch acks;
+    
+    // First ack may wait; the rest are drained without blocking
+    while (requester_->in_flight() > 0 && requester_->receive(acks, timeout_ms)) {
+        if (requester_->complete(acks.batch_id())) {
+            orders_acked_ += acks.statuses_size();
+        }
+        timeout_ms = 0;
+    }
+}
+
+void OrderSubmissionThread::submit_cloud(const PriceGenerationThread::OrderCloud& cloud) {
+    if (cloud.orders.empty()) {
+        return;
+    }
+    
+    // One OrderBatch per cloud (all orders share the symbol)
+    marketsim::exchange::OrderBatch batch;
+    batch.set_batch_id(std::to_string(next_batch_id_++));
+    batch.set_symbol(cloud.orders.front().symbol);
+    
+    for (const auto& order : cloud.orders) {
+        auto* proto_order = batch.add_orders();
+        proto_order->set_order_id(std::to_string(order.order_id));
+        proto_order->set_symbol(order.symbol);
+        proto_order->set_side(order.is_buy ? 
+                              marketsim::exchange::OrderSide::BUY : 
+                              marketsim::exchange::OrderSide::SELL);
+        proto_order->set_type(marketsim::exchange::OrderType::LIMIT);
+        proto_order->set_price(order.price);
+        proto_order->set_quantity(order.volume);
+        proto_order->set_timestamp(order.timestamp_ms);
+        proto_order->set_client_id("TrafficGenerator");
+    }
     
-    // Send to Exchange and wait for acknowledgement
-    marketsim::exchange::OrderAck ack;
-    bool success = requester_->request(proto_order, ack);
+    // Send to Exchange; the ack is collected later by batch id
+    bool success = requester_->send(batch.batch_id(), batch);
     
     if (success) {
-        orders_sent_++;
+        uint64_t previous = orders_sent_.fetch_add(cloud.orders.size());
         
-        // Log every 10 orders
-        if (orders_sent_ % 10 == 0) {
+        // Log roughly every 10 orders
+        if (previous / 10 != orders_sent_ / 10) {
+            const auto& latest = cloud.orders.back();
             std::cout << "[OrderSubmitter] Sent " << orders_sent_ << " orders. "
-                      << "Latest: " << (order.is_buy ? "BUY" : "SELL") 
-                      << " " << order.symbol 
-                      << " @ $" << order.price 
-                      << " qty=" << order.volume << "\n";
+                      << "Latest: " << (latest.is_buy ? "BUY" : "SELL") 
+                      << " " << latest.symbol 
+                      << " @ $" << latest.price 
+                      << " qty=" << latest.volume 
+                      << " (batch of " << cloud.orders.size() << ")\n";
         }
     } else {
-        std::cerr << "[OrderSubmitter] Failed to send order " << order.order_id << "\n";
+        std::cerr << "[OrderSubmitter] Failed to send batch " << batch.batch_id() 
+                  << " (" << cloud.orders.size() << " orders)\n";
     }
 }
 
@@ -1,14 +1,11 @@
 #pragma once
 
 #include "price_generation_thread.h"
-#include "io_handler/zmq_requester.h"
+#include "io_handler/zmq_async_requester.h"
 #include "io_handler/io_context.h"
 #include <thread>
 #include <atomic>
 #include <memory>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
 
 namespace marketsim::traffic_generator::threads {
 
@@ -18,6 +15,10 @@ namespace marketsim::traffic_generator::threads {
  * Consumer thread in producer-consumer pattern.
  * Sole responsibility: Pull order from queue, send to Exchange via ZeroMQ.
  * 
+ * Each generated cloud goes out as one OrderBatch, pipelined over a DEALER
+ * socket: up to max_in_flight batches can await their ack at once, so
+ * throughput is not capped at one round trip per order.
+ * 
  * NO order generation - just network I/O!
  */
 class OrderSubmissionThread {
@@ -25,17 +26,15 @@ public:
     /**
      * @brief Construct order submission thread
      * @param io_context ZeroMQ context
-     * @param endpoint Exchange endpoint (e.g., "tcp://localhost:5555")
-     * @param queue Shared queue to pull ORDERS from
-     * @param queue_mutex Mutex protecting the queue
-     * @param queue_cv Condition variable for signaling
+     * @param endpoint Exchange batch endpoint (e.g., "tcp://localhost:5558")
+     * @param queue Shared ring to pull order clouds from
+     * @param max_in_flight Batches allowed to await an ack at once
      */
     OrderSubmissionThread(
         io_handler::IOContext& io_context,
         const std::string& endpoint,
-        std::queue<PriceGenerationThread::Order>& queue,
-        std::mutex& queue_mutex,
-        std::condition_variable& queue_cv
+        PriceGenerationThread::OrderQueue& queue,
+        size_t max_in_flight = 64
     );
     
     ~OrderSubmissionThread();
@@ -60,20 +59,26 @@ public:
      */
     uint64_t orders_sent() const { return orders_sent_; }
     
+    /**
+     * @brief Get number of orders acknowledged by the Exchange
+     */
+    uint64_t orders_acked() const { return orders_acked_; }
+    
 private:
     void run();
-    void submit_order(const PriceGenerationThread::Order& order);
+    void submit_cloud(const PriceGenerationThread::OrderCloud& cloud);
+    void collect_acks(int timeout_ms);
     
     // I/O
-    std::unique_ptr<io_handler::ZmqRequester> requester_;
+    std::unique_ptr<io_handler::ZmqAsyncRequester> requester_;
     
-    // Shared queue (not owned by this thread)
-    std::queue<PriceGenerationThread::Order>& queue_;
-    std::mutex& queue_mutex_;
-    std::condition_variable& queue_cv_;
+    // Shared ring (not owned by this thread)
+    PriceGenerationThread::OrderQueue& queue_;
     
     // State
     std::atomic<uint64_t> orders_sent_;
+    std::atomic<uint64_t> orders_acked_;
+    uint64_t next_batch_id_;
     
     // Threading
     std::unique_ptr<std::thread> thread_;
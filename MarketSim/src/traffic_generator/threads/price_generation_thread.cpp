@@ -1,5 +1,4 @@
 #include "price_generation_thread.h"
-#include "../utils/time_utils.h"
 #include "../models/price_models/hawkes_microstructure_model.h"
 #include <iostream>
 
@@ -10,16 +9,14 @@ PriceGenerationThread::PriceGenerationThread(
     std::unique_ptr<models::price_models::IPriceModel> price_model,
     int64_t step_interval_ms,
     double duration_seconds,
-    std::queue<Order>& queue,
-    std::mutex& queue_mutex,
-    std::condition_variable& queue_cv)
+    OrderQueue& queue,
+    common::clock::SimClock& clock)
     : symbol_(symbol)
     , price_model_(std::move(price_model))
     , step_interval_ms_(step_interval_ms)
     , duration_seconds_(duration_seconds)
     , queue_(queue)
-    , queue_mutex_(queue_mutex)
-    , queue_cv_(queue_cv)
+    , clock_(clock)
     , orders_generated_(0)
     , next_order_id_(1)
     , running_(false)
@@ -42,8 +39,8 @@ void PriceGenerationThread::start() {
 void PriceGenerationThread::stop() {
     running_ = false;
     
-    // Wake up consumer if blocked
-    queue_cv_.notify_all();
+    // Release a push blocked on a full ring
+    queue_.stop();
     
     if (thread_ && thread_->joinable()) {
         thread_->join();
@@ -61,40 +58,37 @@ void PriceGenerationThread::run() {
     std::cout << "  Initial Price: " << price_model_->current_price() << "\n";
     std::cout << "  Interval: " << step_interval_ms_ << " ms\n";
     std::cout << "  Duration: " << duration_seconds_ << " seconds\n";
+    std::cout << "  Clock: " << common::clock::to_string(clock_.mode()) << "\n";
     
     double t = 0.0;
     double step_seconds = step_interval_ms_ / 1000.0;
     
     while (running_ && t <= duration_seconds_) {
+        // Wait for (real time) or jump to (virtual) this step's time
+        clock_.advance_to_seconds(t);
+        int64_t timestamp_ms = clock_.now_ms();
+        
         // Step model forward
         double new_price = price_model_->next_price();
         
         // Check if model generates orders (e.g., Hawkes)
         auto* hawkes_model = dynamic_cast<models::price_models::HawkesMicrostructureModel*>(price_model_.get());
         
+        cloud_.orders.clear();
+        
         if (hawkes_model && !hawkes_model->current_orders().empty()) {
             // Hawkes model: use generated order clouds
             for (const auto& hawkes_order : hawkes_model->current_orders()) {
-                Order order{
+                cloud_.orders.push_back(Order{
                     .order_id = next_order_id_++,
                     .symbol = symbol_,
                     .is_buy = hawkes_order.is_buy,
                     .price = hawkes_order.price,
                     .volume = hawkes_order.volume,
-                    .timestamp_seconds = t
-                };
-                
-                // Push to queue (thread-safe)
-                {
-                    std::lock_guard<std::mutex> lock(queue_mutex_);
-                    queue_.push(order);
-                }
-                
-                orders_generated_++;
+                    .timestamp_seconds = t,
+                    .timestamp_ms = timestamp_ms
+                });
             }
-            
-            // Notify consumer once per batch
-            queue_cv_.notify_one();
         } else {
             // Simple models (linear, GBM): generate buy+sell at mid-price
             Order buy_order{
@@ -103,7 +97,8 @@ void PriceGenerationThread::run() {
                 .is_buy = true,
                 .price = new_price,
                 .volume = 1.0,
-                .timestamp_seconds = t
+                .timestamp_seconds = t,
+                .timestamp_ms = timestamp_ms
             };
             
             Order sell_order{
@@ -112,30 +107,28 @@ void PriceGenerationThread::run() {
                 .is_buy = false,
                 .price = new_price,
                 .volume = 1.0,
-                .timestamp_seconds = t
+                .timestamp_seconds = t,
+                .timestamp_ms = timestamp_ms
             };
             
-            // Push to queue (thread-safe)
-            {
-                std::lock_guard<std::mutex> lock(queue_mutex_);
-                queue_.push(buy_order);
-                queue_.push(sell_order);
-            }
-            
-            orders_generated_ += 2;
-            queue_cv_.notify_one();
+            cloud_.orders.push_back(std::move(buy_order));
+            cloud_.orders.push_back(std::move(sell_order));
+        }
+        
+        // Publish the step as one cloud (waits if the submitter is behind)
+        size_t cloud_size = cloud_.orders.size();
+        if (queue_.push(std::move(cloud_))) {
+            orders_generated_ += cloud_size;
         }
         
-        // Log every 10 steps
-        if (static_cast<int>(t / step_seconds) % 10 == 0) {
+        // Log every 10 steps (every 1000 when not paced: they come back to back)
+        int log_every = clock_.is_virtual() ? 1000 : 10;
+        if (static_cast<int>(t / step_seconds) % log_every == 0) {
             std::cout << "[OrderGenerator] t=" << t 
                       << "s, price=" << new_price 
                       << ", orders_generated=" << orders_generated_ << "\n";
         }
         
-        // Sleep for interval
-        utils::TimeUtils::sleep_ms(step_interval_ms_);
-        
         // Advance time
         t += step_seconds;
     }
@@ -1,13 +1,13 @@
 #pragma once
 
 #include "../models/price_models/i_price_model.h"
+#include "common/clock/sim_clock.h"
+#include "common/concurrency/spsc_ring.h"
 #include <thread>
 #include <atomic>
 #include <memory>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
 #include <string>
+#include <vector>
 
 namespace marketsim::traffic_generator::threads {
 
@@ -19,6 +19,9 @@ namespace marketsim::traffic_generator::threads {
  * 
  * For simple models (linear, GBM): generates buy+sell at mid-price
  * For Hawkes: generates order clouds with distributed prices
+ * 
+ * Steps are paced by the SimClock: in real time, or back to back (VIRTUAL)
+ * with orders stamped in model time.
  */
 class PriceGenerationThread {
 public:
@@ -31,27 +34,38 @@ public:
         bool is_buy;
         double price;
         double volume;
-        double timestamp_seconds;
+        double timestamp_seconds;   // Model time since the start
+        int64_t timestamp_ms;       // Clock time (ms since epoch) for the wire
+    };
+    
+    /**
+     * @brief Orders generated in one step (a Hawkes cloud, or a buy+sell pair)
+     */
+    struct OrderCloud {
+        std::vector<Order> orders;
     };
     
+    /**
+     * @brief Lock-free hand-off to the submission thread (one producer, one consumer)
+     */
+    using OrderQueue = common::concurrency::SpscRing<OrderCloud>;
+    
     /**
      * @brief Construct price generation thread with a price model
      * @param symbol Trading symbol
      * @param price_model Unique pointer to price model (ownership transferred)
      * @param step_interval_ms Time between price updates (milliseconds)
      * @param duration_seconds Total duration to generate prices
-     * @param queue Shared queue to push ORDERS to
-     * @param queue_mutex Mutex protecting the queue
-     * @param queue_cv Condition variable for signaling
+     * @param queue Shared ring to push order clouds to (waits when full)
+     * @param clock Simulation clock the steps advance
      */
     PriceGenerationThread(
         const std::string& symbol,
         std::unique_ptr<models::price_models::IPriceModel> price_model,
         int64_t step_interval_ms,
         double duration_seconds,
-        std::queue<Order>& queue,
-        std::mutex& queue_mutex,
-        std::condition_variable& queue_cv
+        OrderQueue& queue,
+        common::clock::SimClock& clock
     );
     
     ~PriceGenerationThread();
@@ -94,10 +108,12 @@ private:
     int64_t step_interval_ms_;
     double duration_seconds_;
     
-    // Shared queue (not owned by this thread)
-    std::queue<Order>& queue_;
-    std::mutex& queue_mutex_;
-    std::condition_variable& queue_cv_;
+    // Shared ring and clock (not owned by this thread)
+    OrderQueue& queue_;
+    common::clock::SimClock& clock_;
+    
+    // Current step's orders, published as one ring entry
+    OrderCloud cloud_;
     
     // State
     std::atomic<uint64_t> orders_generated_;
@@ -0,0 +1,316 @@
+#include "exchange/operations/matching_engine.h"
+#include "traffic_generator/models/price_models/hawkes_microstructure_model.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// Microbenchmarks for OrderBook/MatchingEngine. Build in Release, then e.g.:
+//   bench_matching_engine --benchmark_filter=Sweep --benchmark_repetitions=5
+// Every benchmark reports ns/order, orders/s (items_per_second) and allocs/order.
+
+using namespace marketsim::exchange::operations;
+using marketsim::exchange::Order;
+using marketsim::exchange::OrderSide;
+using marketsim::exchange::OrderType;
+
+// ============================================================================
+// Allocation counting (whole process; read around the timed calls only)
+// ============================================================================
+
+namespace {
+std::atomic<uint64_t> g_allocations{0};
+}
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// Over-aligned types (e.g. alignas(64) SymbolPriceData) come through here
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    auto align = static_cast<std::size_t>(alignment);
+    std::size_t rounded = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+    if (void* p = std::aligned_alloc(align, rounded)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+constexpr const char* kSymbol = "BENCH";
+constexpr double kMid = 100.0;
+constexpr double kTick = 0.01;
+
+// ============================================================================
+// Order tapes (built once, outside the timed region)
+// ============================================================================
+
+struct TapeEntry {
+    Order order;
+    bool cancel = false;   // Cancel order.order_id() instead of submitting
+};
+
+using Tape = std::vector<TapeEntry>;
+
+Order make_order(uint64_t id, OrderSide side, double price, double quantity,
+                 OrderType type = OrderType::LIMIT) {
+    Order order;
+    order.set_order_id("O" + std::to_string(id));
+    order.set_symbol(kSymbol);
+    order.set_side(side);
+    order.set_type(type);
+    order.set_price(price);
+    order.set_quantity(quantity);
+    order.set_timestamp(static_cast<int64_t>(id));
+    order.set_client_id("BENCH");
+    return order;
+}
+
+// Non-crossing limits spread over `levels` price levels per side
+Tape add_only_tape(size_t count, int levels, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> level(1, levels);
+    Tape tape(count);
+    for (size_t i = 0; i < count; ++i) {
+        bool buy = i % 2 == 0;
+        double offset = level(rng) * kTick;
+        tape[i].order = make_order(i, buy ? OrderSide::BUY : OrderSide::SELL,
+                                   buy ? kMid - offset : kMid + offset, 1.0 + rng() % 10);
+    }
+    return tape;
+}
+
+// Resting flow where most orders are cancelled soon after they arrive
+Tape cancel_heavy_tape(size_t adds, double cancel_ratio, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> level(1, 50);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::vector<uint64_t> live;
+    Tape tape;
+    tape.reserve(adds * 2);
+    for (uint64_t i = 0; i < adds; ++i) {
+        bool buy = i % 2 == 0;
+        double offset = level(rng) * kTick;
+        TapeEntry add;
+        add.order = make_order(i, buy ? OrderSide::BUY : OrderSide::SELL,
+                               buy ? kMid - offset : kMid + offset, 1.0 + rng() % 10);
+        tape.push_back(std::move(add));
+        live.push_back(i);
+
+        if (coin(rng) < cancel_ratio && !live.empty()) {
+            // Mostly recent orders, as quoting strategies do
+            size_t back = std::min<size_t>(live.size(), 1 + rng() % 8);
+            size_t pick = live.size() - back;
+            TapeEntry cancel;
+            cancel.cancel = true;
+            cancel.order.set_order_id("O" + std::to_string(live[pick]));
+            cancel.order.set_symbol(kSymbol);
+            tape.push_back(std::move(cancel));
+            live[pick] = live.back();
+            live.pop_back();
+        }
+    }
+    return tape;
+}
+
+// Seeded Hawkes order clouds, as the traffic generator would submit them
+Tape hawkes_tape(size_t count, uint64_t seed) {
+    using marketsim::traffic_generator::models::GenerationParameters;
+    using marketsim::traffic_generator::models::price_models::HawkesMicrostructureModel;
+
+    GenerationParameters params;
+    params.base_price = kMid;
+    params.enable_regime_switching = false;  // Same base regime throughout (and no console output)
+    // dt sized so most steps produce an event, which makes a long tape span
+    // centuries of simulated time: without drift the mid wanders instead of
+    // compounding off to infinity
+    params.drift = 0.0;
+    HawkesMicrostructureModel model(params.base_price, params.drift / 100.0,
+                                    params.volatility / 100.0, 0.01, params, seed);
+    Tape tape;
+    tape.reserve(count);
+    uint64_t id = 0;
+    while (tape.size() < count) {
+        model.next_price();
+        for (const auto& generated : model.current_orders()) {
+            if (tape.size() == count) {
+                break;
+            }
+            TapeEntry entry;
+            entry.order = make_order(id++, generated.is_buy ? OrderSide::BUY : OrderSide::SELL,
+                                     generated.price, generated.volume);
+            tape.push_back(std::move(entry));
+        }
+    }
+    return tape;
+}
+
+// ============================================================================
+// Runner
+// ============================================================================
+
+std::unique_ptr<MatchingEngine> make_engine(size_t expected_orders) {
+    return std::make_unique<MatchingEngine>(kSymbol, 100, kTick, 4096, expected_orders);
+}
+
+// Replay `tape` into a fresh engine per iteration (prepared by `setup`, untimed).
+// Cancels count as orders in the per-order figures.
+template<typename Setup>
+void run_tape(benchmark::State& state, const Tape& tape, Setup setup) {
+    std::vector<Fill> fills;
+    fills.reserve(1024);
+    uint64_t allocations = 0;
+    uint64_t trades = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto engine = make_engine(tape.size());
+        setup(*engine);
+        state.ResumeTiming();
+
+        uint64_t before = g_allocations.load(std::memory_order_relaxed);
+        for (const auto& entry : tape) {
+            if (entry.cancel) {
+                benchmark::DoNotOptimize(engine->cancel_order(entry.order.order_id(), kSymbol));
+            } else {
+                fills.clear();
+                benchmark::DoNotOptimize(engine->match_order(entry.order, fills));
+            }
+        }
+        allocations += g_allocations.load(std::memory_order_relaxed) - before;
+
+        state.PauseTiming();
+        trades += engine->total_trades();
+        engine.reset();  // Teardown isn't what we measure
+        state.ResumeTiming();
+    }
+
+    auto orders = static_cast<double>(state.iterations() * tape.size());
+    state.SetItemsProcessed(static_cast<int64_t>(orders));
+    state.counters["ns/order"] = benchmark::Counter(orders, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["allocs/order"] = benchmark::Counter(static_cast<double>(allocations) / orders);
+    state.counters["trades/order"] = benchmark::Counter(static_cast<double>(trades) / orders);
+}
+
+void no_setup(MatchingEngine&) {}
+
+// ============================================================================
+// Scenarios
+// ============================================================================
+
+// Passive orders only: level creation and FIFO append. Arg: levels per side
+void BM_AddOnly(benchmark::State& state) {
+    Tape tape = add_only_tape(10000, static_cast<int>(state.range(0)), 1);
+    run_tape(state, tape, no_setup);
+}
+BENCHMARK(BM_AddOnly)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+// One aggressive buy taking out N ask levels of 4 orders each. Arg: levels swept
+void BM_AggressiveSweep(benchmark::State& state) {
+    const int levels = static_cast<int>(state.range(0));
+    constexpr int kOrdersPerLevel = 4;
+
+    Tape book;
+    uint64_t id = 0;
+    for (int level = 1; level <= levels; ++level) {
+        for (int i = 0; i < kOrdersPerLevel; ++i) {
+            TapeEntry entry;
+            entry.order = make_order(id++, OrderSide::SELL, kMid + level * kTick, 1.0);
+            book.push_back(std::move(entry));
+        }
+    }
+
+    // Many sweeps per iteration, each against its own copy of the book; the
+    // books are built in one untimed block so pausing the timer doesn't skew
+    // sub-microsecond sweeps
+    constexpr int kSweeps = 64;
+    Tape tape;
+    for (int s = 0; s < kSweeps; ++s) {
+        TapeEntry sweep;
+        sweep.order = make_order(1000000 + s, OrderSide::BUY, kMid + levels * kTick,
+                                 static_cast<double>(levels * kOrdersPerLevel));
+        tape.push_back(std::move(sweep));
+    }
+
+    std::vector<Fill> fills;
+    std::vector<Fill> scratch;
+    std::vector<std::unique_ptr<MatchingEngine>> engines(kSweeps);
+    uint64_t allocations = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (auto& engine : engines) {
+            engine = make_engine(book.size() + 1);
+            for (const auto& entry : book) {
+                engine->match_order(entry.order, scratch);
+            }
+        }
+        state.ResumeTiming();
+
+        uint64_t before = g_allocations.load(std::memory_order_relaxed);
+        for (int s = 0; s < kSweeps; ++s) {
+            fills.clear();
+            benchmark::DoNotOptimize(engines[s]->match_order(tape[s].order, fills));
+        }
+        allocations += g_allocations.load(std::memory_order_relaxed) - before;
+    }
+
+    auto sweeps = static_cast<double>(state.iterations() * tape.size());
+    state.SetItemsProcessed(static_cast<int64_t>(sweeps));
+    state.counters["ns/order"] = benchmark::Counter(sweeps, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["allocs/order"] = benchmark::Counter(static_cast<double>(allocations) / sweeps);
+    state.counters["fills/order"] = benchmark::Counter(static_cast<double>(levels * kOrdersPerLevel));
+}
+BENCHMARK(BM_AggressiveSweep)->Arg(1)->Arg(4)->Arg(16)->Arg(64);
+
+// Add/cancel churn near the touch. Arg: cancels per 100 adds
+void BM_CancelHeavy(benchmark::State& state) {
+    Tape tape = cancel_heavy_tape(10000, static_cast<double>(state.range(0)) / 100.0, 2);
+    run_tape(state, tape, no_setup);
+}
+BENCHMARK(BM_CancelHeavy)->Arg(50)->Arg(90)->Arg(99);
+
+// N makers queued at one price, then N unit takers each filling the head. Arg: queue depth
+void BM_DeepFifo(benchmark::State& state) {
+    const size_t depth = static_cast<size_t>(state.range(0));
+    Tape makers(depth);
+    Tape takers(depth);
+    for (size_t i = 0; i < depth; ++i) {
+        makers[i].order = make_order(i, OrderSide::SELL, kMid, 1.0);
+        takers[i].order = make_order(depth + i, OrderSide::BUY, kMid, 1.0);
+    }
+
+    run_tape(state, takers, [&makers](MatchingEngine& engine) {
+        std::vector<Fill> scratch;
+        for (const auto& entry : makers) {
+            engine.match_order(entry.order, scratch);
+        }
+    });
+}
+BENCHMARK(BM_DeepFifo)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// Seeded Hawkes flow (mixed passive/aggressive). Arg: orders replayed
+void BM_HawkesFlow(benchmark::State& state) {
+    Tape tape = hawkes_tape(static_cast<size_t>(state.range(0)), 42);
+    run_tape(state, tape, no_setup);
+}
+BENCHMARK(BM_HawkesFlow)->Arg(10000)->Arg(100000);
+
+}
+
+BENCHMARK_MAIN();
@@ -8,10 +8,19 @@ using namespace marketsim;
  * 
  * Just instantiates and runs the ExchangeService.
  * All logic is in src/exchange/main/exchange_service.cpp
+ *
+ * Usage: test_exchange_server [realtime|virtual]
+ *   virtual: match on the order timestamps, for a generator on a virtual clock
  */
-int main() {
+int main(int argc, char* argv[]) {
+    exchange::config::ExchangeConfig config;
+    if (argc > 1 && !common::clock::parse_clock_mode(argv[1], config.clock_mode)) {
+        std::cerr << "Usage: " << argv[0] << " [realtime|virtual]\n";
+        return 1;
+    }
+    
     try {
-        exchange::main::ExchangeService service;
+        exchange::main::ExchangeService service(config);
         service.run();
     } catch (const std::exception& e) {
         std::cerr << "[EXCHANGE] Error: " << e.what() << "\n";
@@ -1,6 +1,7 @@
 #include "monitor/status_monitor.h"
 #include "monitor/monitor_helpers.h"
 #include <iostream>
+#include <memory>
 #include <thread>
 #include <chrono>
 #include <vector>
@@ -8,8 +9,8 @@
 
 using namespace marketsim::monitor;
 
-// Simulate a worker thread
-void worker_thread(const std::string& name, int task_count) {
+// Simulate a worker thread (recording into its own histogram)
+void worker_thread(const std::string& name, int task_count, std::shared_ptr<LatencyHistogram> work_latency) {
     MonitoredThread monitor(name);
     
     std::random_device rd;
@@ -20,7 +21,10 @@ void worker_thread(const std::string& name, int task_count) {
         monitor.update_state(ThreadState::RUNNING);
         
         // Simulate work
-        std::this_thread::sleep_for(std::chrono::milliseconds(delay(gen)));
+        {
+            ScopedLatency timer(*work_latency);
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay(gen)));
+        }
         
         monitor.increment_tasks();
         monitor.update_activity();
@@ -86,9 +90,16 @@ int main() {
     // Launch worker threads
     std::vector<std::thread> threads;
     
-    threads.emplace_back(worker_thread, "OrderProcessor", 10);
-    threads.emplace_back(worker_thread, "TradeExecutor", 8);
-    threads.emplace_back(worker_thread, "DataAggregator", 12);
+    // One histogram per worker; the "work" rows merge in print_status(). Held
+    // here too, so the final status still reports them after the workers exit
+    std::vector<std::shared_ptr<LatencyHistogram>> work_latencies;
+    for (int i = 0; i < 3; ++i) {
+        work_latencies.push_back(StatusMonitor::instance().register_latency("work"));
+    }
+    
+    threads.emplace_back(worker_thread, "OrderProcessor", 10, work_latencies[0]);
+    threads.emplace_back(worker_thread, "TradeExecutor", 8, work_latencies[1]);
+    threads.emplace_back(worker_thread, "DataAggregator", 12, work_latencies[2]);
     
     // Launch socket threads
     threads.emplace_back(socket_thread, "OrderSocket", SocketType::REQ);
@@ -3,20 +3,19 @@
 #include "traffic_generator/models/generation_parameters.h"
 #include "traffic_generator/models/price_models/price_model_factory.h"
 #include "io_handler/io_context.h"
+#include <chrono>
 #include <iostream>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
 
 using namespace marketsim;
 
 void print_usage(const char* program_name) {
-    std::cout << "Usage: " << program_name << " <model_name>\n";
+    std::cout << "Usage: " << program_name << " <model_name> [realtime|virtual]\n";
     std::cout << "\nAvailable models:\n";
     std::cout << "  " << traffic_generator::models::price_models::PriceModelFactory::available_models() << "\n";
     std::cout << "\nExamples:\n";
     std::cout << "  " << program_name << " linear\n";
     std::cout << "  " << program_name << " gbm\n";
+    std::cout << "  " << program_name << " hawkes virtual   (no pacing: 5 simulated minutes as fast as the Exchange acks)\n";
 }
 
 int main(int argc, char* argv[]) {
@@ -36,13 +35,17 @@ int main(int argc, char* argv[]) {
         std::cout << "Use --help to see available models\n\n";
     }
     
+    common::clock::ClockMode clock_mode = common::clock::ClockMode::REAL_TIME;
+    if (argc > 2 && !common::clock::parse_clock_mode(argv[2], clock_mode)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
     std::cout << "=== Traffic Generator with " << model_name << " Model ===\n\n";
     
     
-    // Shared queue for producer-consumer pattern (ORDERS, not prices!)
-    std::queue<traffic_generator::threads::PriceGenerationThread::Order> order_queue;
-    std::mutex queue_mutex;
-    std::condition_variable queue_cv;
+    // Shared ring for producer-consumer pattern (ORDERS, not prices!)
+    traffic_generator::threads::PriceGenerationThread::OrderQueue order_queue(1024);
     
     // Configuration
     traffic_generator::models::GenerationParameters config;
@@ -54,8 +57,10 @@ int main(int argc, char* argv[]) {
     config.drift = 5.0;             // 5% annual drift (for GBM)
     config.volatility = 3.0;        // 3% annual volatility (for GBM)
     config.price_rate = 0.1;        // $0.10 per second (for linear)
+    config.clock_mode = clock_mode;
     
-    std::string exchange_endpoint = "tcp://localhost:5555";
+    // Batch gateway: each order cloud is submitted as one OrderBatch
+    std::string exchange_endpoint = "tcp://localhost:5558";
     
     // Create IOContext for order submission
     io_handler::IOContext io_context;
@@ -83,7 +88,9 @@ int main(int argc, char* argv[]) {
         std::cout << "  Rate: $" << config.price_rate << " per second\n";
     }
     std::cout << "  Interval: " << config.step_interval_ms << " ms\n";
+    std::cout << "  Batches In Flight: " << config.max_in_flight_batches << "\n";
     std::cout << "  Duration: " << config.duration_seconds << " seconds\n";
+    std::cout << "  Clock: " << common::clock::to_string(config.clock_mode) << "\n";
     std::cout << "  Total Steps: " << total_steps << "\n";
     std::cout << "  Simulated Time Per Step: " << dt << " years\n\n";
     
@@ -104,6 +111,9 @@ int main(int argc, char* argv[]) {
     
     std::cout << "Model Description: " << price_model->description() << "\n\n";
     
+    // Simulation clock: paces the steps (real time) or lets them run back to back (virtual)
+    common::clock::SimClock clock(config.clock_mode);
+    
     // Create producer thread (runs model, generates ORDERS)
     traffic_generator::threads::PriceGenerationThread order_generator_thread(
         config.symbol,
@@ -111,8 +121,7 @@ int main(int argc, char* argv[]) {
         static_cast<int64_t>(config.step_interval_ms),
         config.duration_seconds,
         order_queue,
-        queue_mutex,
-        queue_cv
+        clock
     );
     
     // Create consumer thread (submits orders to Exchange)
@@ -120,12 +129,13 @@ int main(int argc, char* argv[]) {
         io_context,
         exchange_endpoint,
         order_queue,
-        queue_mutex,
-        queue_cv
+        static_cast<size_t>(config.max_in_flight_batches)
     );
     
     // Start both threads
     std::cout << "Starting threads...\n\n";
+    clock.restart();
+    auto wall_start = std::chrono::steady_clock::now();
     order_generator_thread.start();
     order_submitter_thread.start();
     
@@ -143,7 +153,11 @@ int main(int argc, char* argv[]) {
     std::cout << "Model: " << model_name << "\n";
     std::cout << "Orders Generated: " << order_generator_thread.orders_generated() << "\n";
     std::cout << "Orders Sent: " << order_submitter_thread.orders_sent() << "\n";
+    std::cout << "Orders Acked: " << order_submitter_thread.orders_acked() << "\n";
     std::cout << "Queue Size: " << order_queue.size() << " (should be 0)\n";
+    std::cout << "Simulated: " << clock.elapsed_seconds() << " s in "
+              << std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count()
+              << " s wall clock\n";
     
     return 0;
 }